@@ -0,0 +1,105 @@
+/**
+* Benchmark of loading columns and computing their means and variances:
+* memory-mapped `ColumnFile`, against parsing the same values from a CSV file
+* with `std::ifstream` and with `CsvReader`.
+*
+* g++ -std=c++11 -O2 -pthread -Iinclude benchmarks/column_file.cpp -o column_file
+*/
+#include "CColumnFile.hpp"
+#include "CCsvReader.hpp"
+#include "Stats.hpp"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	const size_t n_rows = 2000000, n_cols = 4;
+	const std::string csv_path = "column_file_benchmark.csv", column_path = "column_file_benchmark.col";
+
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> normal(0, 1);
+	std::vector<std::vector<double>> x(n_cols, std::vector<double>(n_rows));
+	for (auto& col : x)
+		for (auto& e : col)
+			e = normal(rng);
+
+	{
+		std::ofstream csv(csv_path);
+		csv.precision(17);
+		for (size_t j = 0; j < n_cols; ++j)
+			csv << (j ? "," : "") << "c" << j;
+		csv << "\n";
+		for (size_t i = 0; i < n_rows; ++i)
+		{
+			for (size_t j = 0; j < n_cols; ++j)
+				csv << (j ? "," : "") << x[j][i];
+			csv << "\n";
+		}
+		ColumnFileWriter writer;
+		for (size_t j = 0; j < n_cols; ++j)
+			writer.add_column("c" + std::to_string(j), x[j]);
+		writer.write(column_path);
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	double sum_stream = 0;
+	{
+		std::ifstream csv(csv_path);
+		std::string line;
+		std::getline(csv, line);
+		std::vector<std::vector<double>> y(n_cols);
+		double value;
+		char delimiter;
+		for (size_t i = 0; i < n_rows; ++i)
+			for (size_t j = 0; j < n_cols; ++j)
+			{
+				csv >> value;
+				if (j + 1 < n_cols)
+					csv >> delimiter;
+				y[j].push_back(value);
+			}
+		for (const auto& col : y)
+			sum_stream += Stats::mean(col) + Stats::var(col);
+	}
+	double t_stream = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	double sum_csv = 0;
+	{
+		CsvReader reader(csv_path, ',', true, false);
+		for (size_t j = 0; j < n_cols; ++j)
+			sum_csv += Stats::mean(reader.column(j)) + Stats::var(reader.column(j));
+	}
+	double t_csv = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	double sum_column = 0;
+	{
+		ColumnFile file(column_path);
+		for (size_t j = 0; j < n_cols; ++j)
+		{
+			ArrayView<const double> col = file.column<double>("c" + std::to_string(j));
+			sum_column += Stats::mean(col) + Stats::var(col);
+		}
+	}
+	double t_column = seconds_since(start);
+
+	std::remove(csv_path.c_str());
+	std::remove(column_path.c_str());
+
+	printf("values                  %zu rows x %zu columns\n", n_rows, n_cols);
+	printf("std::ifstream           %8.3f s  checksum %.6f\n", t_stream, sum_stream);
+	printf("CsvReader               %8.3f s  checksum %.6f\n", t_csv, sum_csv);
+	printf("ColumnFile              %8.3f s  checksum %.6f\n", t_column, sum_column);
+	return 0;
+}
@@ -0,0 +1,80 @@
+/**
+* Benchmark of `Stats::var` and `Stats::hmean` on `std::vector`, `std::deque` and `std::list` inputs,
+* whose temporaries are contiguous cache-aligned buffers, against temporaries of the type of the input
+* (one heap node per value for `std::list`).
+* `std::deque`, already stored by blocks, gains little: its two large temporaries may even be slower
+* with allocators giving them back to the system after each call, like glibc `malloc` by default,
+* each call then paying page faults on fresh memory.
+*
+* g++ -std=c++11 -O2 -pthread -Iinclude benchmarks/contiguous.cpp -o contiguous
+*/
+#include "Stats.hpp"
+#include <chrono>
+#include <cstdio>
+#include <deque>
+#include <list>
+#include <numeric>
+#include <random>
+#include <vector>
+
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+/**
+* Variance and harmonic mean with temporaries of the type of the input.
+*/
+template<template<typename, typename> class ContType>
+static double var_hmean_same_type(const ContType<double, std::allocator<double>>& x)
+{
+	double mean = std::accumulate(x.begin(), x.end(), 0.0) / x.size();
+	ContType<double, std::allocator<double>> x_cent(x.begin(), x.end());
+	for (auto& e : x_cent)
+		e -= mean;
+	double var = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0) / x.size();
+	ContType<double, std::allocator<double>> x_inv(x.begin(), x.end());
+	for (auto& e : x_inv)
+		e = 1 / e;
+	double hmean = x.size() / std::accumulate(x_inv.begin(), x_inv.end(), 0.0);
+	return var + hmean;
+}
+
+template<template<typename, typename> class ContType>
+static void run(const char* name, const std::vector<double>& values, size_t repeats)
+{
+	ContType<double, std::allocator<double>> x(values.begin(), values.end());
+
+	auto start = std::chrono::steady_clock::now();
+	double sum_stats = 0;
+	for (size_t r = 0; r < repeats; ++r)
+		sum_stats += Stats::var(x) + Stats::hmean(x);
+	double t_stats = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	double sum_same = 0;
+	for (size_t r = 0; r < repeats; ++r)
+		sum_same += var_hmean_same_type(x);
+	double t_same = seconds_since(start);
+
+	printf("%-12s contiguous %8.3f s  same type %8.3f s  speedup %5.2fx  checksums %.6f %.6f\n",
+		name, t_stats, t_same, t_same / t_stats, sum_stats, sum_same);
+}
+
+int main()
+{
+	const size_t n = 1000000, repeats = 20;
+
+	std::mt19937_64 rng(42);
+	std::uniform_real_distribution<double> uniform(1, 2);
+	std::vector<double> values(n);
+	for (auto& e : values)
+		e = uniform(rng);
+
+	printf("values                  %zu, %zu repeats of var and hmean\n", n, repeats);
+	run<std::vector>("std::vector", values, repeats);
+	run<std::deque>("std::deque", values, repeats);
+	run<std::list>("std::list", values, repeats);
+	return 0;
+}
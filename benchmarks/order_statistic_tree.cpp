@@ -0,0 +1,59 @@
+/**
+* Benchmark of rolling medians with `OrderStatisticTree` (insert, erase and median in O(log n)),
+* against `Stats::median` called on each window.
+*
+* g++ -std=c++11 -O2 -pthread -Iinclude benchmarks/order_statistic_tree.cpp -o order_statistic_tree
+*/
+#include "COrderStatisticTree.hpp"
+#include "Stats.hpp"
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	const size_t n = 50000, window = 1000;
+
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> normal(0, 1);
+	std::vector<double> x(n);
+	for (auto& e : x)
+		e = normal(rng);
+
+	auto start = std::chrono::steady_clock::now();
+	OrderStatisticTree tree;
+	double sum_tree = 0;
+	for (size_t i = 0; i < n; ++i)
+	{
+		tree.insert(x[i]);
+		if (i >= window)
+			tree.erase(x[i - window]);
+		if (i + 1 >= window)
+			sum_tree += tree.median();
+	}
+	double t_tree = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	double sum_median = 0;
+	for (size_t i = window; i <= n; ++i)
+	{
+		std::vector<double> w(x.begin() + (i - window), x.begin() + i);
+		sum_median += Stats::median(w);
+	}
+	double t_median = seconds_since(start);
+
+	size_t n_windows = n - window + 1;
+	printf("windows                 %zu of %zu values\n", n_windows, window);
+	printf("OrderStatisticTree      %8.3f s  %8.3f us/window  checksum %.6f\n",
+		t_tree, t_tree / n_windows * 1e6, sum_tree);
+	printf("Stats::median           %8.3f s  %8.3f us/window  checksum %.6f\n",
+		t_median, t_median / n_windows * 1e6, sum_median);
+	return 0;
+}
@@ -0,0 +1,57 @@
+/**
+* Benchmark of streaming outlier detection with `OutlierDetector`,
+* against robust z-scores recomputed per batch with `Stats::median_abs_deviation`.
+*
+* g++ -std=c++11 -O2 -pthread -Iinclude benchmarks/outlier_detector.cpp -o outlier_detector
+*/
+#include "COutlierDetector.hpp"
+#include "Stats.hpp"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+
+static double seconds_since(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main()
+{
+	const size_t n = 2000000, batch_size = 1000;
+	const double threshold = 3.5;
+
+	std::mt19937_64 rng(42);
+	std::normal_distribution<double> normal(0, 1);
+	std::uniform_real_distribution<double> uniform(0, 1);
+	std::vector<double> x(n);
+	for (auto& e : x)
+		e = uniform(rng) < 0.001 ? 20 * normal(rng) : normal(rng);
+
+	auto start = std::chrono::steady_clock::now();
+	OutlierDetector detector(threshold);
+	for (double e : x)
+		detector.push(e);
+	double t_stream = seconds_since(start);
+
+	start = std::chrono::steady_clock::now();
+	size_t batch_count = 0;
+	for (size_t i = 0; i + batch_size <= n; i += batch_size)
+	{
+		std::vector<double> batch(x.begin() + i, x.begin() + i + batch_size);
+		double med = Stats::median(batch), mad = Stats::median_abs_deviation(batch, true);
+		for (double e : batch)
+			if (std::fabs(e - med) > threshold * mad)
+				batch_count++;
+	}
+	double t_batch = seconds_since(start);
+
+	printf("values                  %zu\n", n);
+	printf("OutlierDetector::push   %8.3f s  %8.1f Mvalues/s  %zu outliers\n",
+		t_stream, n / t_stream / 1e6, detector.get_outlier_count());
+	printf("median_abs_deviation    %8.3f s  %8.1f Mvalues/s  %zu outliers (batches of %zu)\n",
+		t_batch, n / t_batch / 1e6, batch_count, batch_size);
+	return 0;
+}
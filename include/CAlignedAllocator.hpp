@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+
+/**
+* Allocator adapter aligning buffers on cache lines, allocating their memory with an inner allocator.
+*
+* Each buffer is over-allocated by `Alignment` bytes from the inner allocator, and starts at the first aligned address
+* after the start of the inner buffer, their distance being stored in the byte before the buffer.
+* Inner allocators like `ArenaAllocator` keep allocating in their arena.
+*
+* @tparam ValType The type of the allocated values.
+* @tparam Alloc The inner allocator.
+* @tparam Alignment Alignment in bytes, a power of two, at most 256.
+*/
+template<typename ValType, typename Alloc = std::allocator<ValType>, size_t Alignment = 64>
+class AlignedAllocator
+{
+	static_assert(Alignment > 0 && Alignment <= 256 && (Alignment & (Alignment - 1)) == 0,
+		"Alignment must be a power of two, at most 256.");
+
+public:
+
+	typedef ValType value_type;
+	typedef typename std::allocator_traits<Alloc>::template rebind_alloc<unsigned char> ByteAlloc;
+
+	template<typename OtherType>
+	struct rebind
+	{
+		typedef AlignedAllocator<OtherType, typename std::allocator_traits<Alloc>::template rebind_alloc<OtherType>, Alignment> other;
+	};
+
+	AlignedAllocator() {}
+
+	AlignedAllocator(const Alloc& inner) : _inner(inner) {}
+
+	template<typename OtherType, typename OtherAlloc>
+	AlignedAllocator(const AlignedAllocator<OtherType, OtherAlloc, Alignment>& other) : _inner(other.get_inner()) {}
+
+	const ByteAlloc& get_inner() const { return _inner; }
+
+	ValType* allocate(size_t n)
+	{
+		unsigned char* raw = std::allocator_traits<ByteAlloc>::allocate(_inner, n * sizeof(ValType) + Alignment);
+		size_t offset = Alignment - reinterpret_cast<uintptr_t>(raw) % Alignment;
+		unsigned char* p = raw + offset;
+		p[-1] = static_cast<unsigned char>(offset - 1);
+		return reinterpret_cast<ValType*>(p);
+	}
+
+	void deallocate(ValType* p, size_t n)
+	{
+		unsigned char* b = reinterpret_cast<unsigned char*>(p);
+		std::allocator_traits<ByteAlloc>::deallocate(_inner, b - (b[-1] + 1), n * sizeof(ValType) + Alignment);
+	}
+
+	template<typename OtherType, typename OtherAlloc>
+	bool operator==(const AlignedAllocator<OtherType, OtherAlloc, Alignment>& other) const { return _inner == other.get_inner(); }
+
+	template<typename OtherType, typename OtherAlloc>
+	bool operator!=(const AlignedAllocator<OtherType, OtherAlloc, Alignment>& other) const { return !(*this == other); }
+
+protected:
+
+	ByteAlloc _inner;
+};
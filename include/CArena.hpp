@@ -0,0 +1,145 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+
+/**
+* Monotonic arena: memory is allocated by bumping a pointer in large blocks,
+* never freed individually, and released at once.
+*
+* A batch of computations can allocate its results and temporaries in an arena,
+* through `ArenaAllocator`, and release them all at the end of the batch.
+* An arena is not thread-safe.
+*/
+class Arena
+{
+public:
+
+	/**
+	* Create empty arena.
+	*
+	* @param block_size Minimal number of bytes of the blocks allocated from the heap.
+	*/
+	explicit Arena(size_t block_size = 1 << 20)
+		: _block_size(block_size), _ptr(nullptr), _left(0), _allocated(0)
+	{
+		if (block_size == 0)
+			throw std::invalid_argument("Block size must be positive.");
+	}
+
+	~Arena()
+	{
+		release();
+	}
+
+	/**
+	* Allocate memory, in O(1), by bumping a pointer in the current block.
+	*
+	* @param bytes Number of bytes.
+	* @param alignment Alignment, a power of two.
+	*/
+	void* allocate(size_t bytes, size_t alignment = alignof(std::max_align_t))
+	{
+		size_t pad = (alignment - reinterpret_cast<uintptr_t>(_ptr) % alignment) % alignment;
+		if (_ptr == nullptr || pad + bytes > _left)
+		{
+			size_t size = std::max(_block_size, bytes + alignment);
+			_blocks.push_back(static_cast<char*>(::operator new(size)));
+			_ptr = _blocks.back(), _left = size;
+			pad = (alignment - reinterpret_cast<uintptr_t>(_ptr) % alignment) % alignment;
+		}
+		void* p = _ptr + pad;
+		_ptr += pad + bytes, _left -= pad + bytes;
+		_allocated += bytes;
+		return p;
+	}
+
+	/**
+	* Release all memory allocated in the arena, invalidating all containers using it.
+	*/
+	void release()
+	{
+		for (auto b : _blocks)
+			::operator delete(b);
+		_blocks.clear();
+		_ptr = nullptr, _left = 0;
+		_allocated = 0;
+	}
+
+	/**
+	* Number of bytes allocated since the creation or the last release.
+	*/
+	size_t get_allocated_size() const { return _allocated; }
+
+	size_t get_block_count() const { return _blocks.size(); }
+
+protected:
+
+	Arena(const Arena&);
+	Arena& operator=(const Arena&);
+
+	size_t _block_size;
+	std::vector<char*> _blocks;
+	char* _ptr;
+	size_t _left, _allocated;
+};
+
+
+/**
+* Allocator of a monotonic arena, for the containers of results and temporaries of the library.
+*
+* Deallocation is a no-op, memory being released with the arena.
+* A default-constructed allocator has no arena and allocates on the heap.
+*
+* @tparam ValType The type of the allocated values.
+*/
+template<typename ValType>
+class ArenaAllocator
+{
+public:
+
+	typedef ValType value_type;
+
+	template<typename OtherType>
+	struct rebind
+	{
+		typedef ArenaAllocator<OtherType> other;
+	};
+
+	ArenaAllocator() : _arena(nullptr) {}
+
+	ArenaAllocator(Arena& arena) : _arena(&arena) {}
+
+	template<typename OtherType>
+	ArenaAllocator(const ArenaAllocator<OtherType>& other) : _arena(other.get_arena()) {}
+
+	Arena* get_arena() const { return _arena; }
+
+	ValType* allocate(size_t n)
+	{
+		if (_arena == nullptr)
+			return static_cast<ValType*>(::operator new(n * sizeof(ValType)));
+		return static_cast<ValType*>(_arena->allocate(n * sizeof(ValType), alignof(ValType)));
+	}
+
+	void deallocate(ValType* p, size_t)
+	{
+		if (_arena == nullptr)
+			::operator delete(p);
+	}
+
+	template<typename OtherType>
+	bool operator==(const ArenaAllocator<OtherType>& other) const { return _arena == other.get_arena(); }
+
+	template<typename OtherType>
+	bool operator!=(const ArenaAllocator<OtherType>& other) const { return _arena != other.get_arena(); }
+
+protected:
+
+	Arena* _arena;
+};
@@ -0,0 +1,551 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+#include <initializer_list>
+#include <type_traits>
+
+
+/**
+* Contiguous view of values, without copy, consumable by all functions of Maths.hpp and Stats.hpp.
+*
+* A view either refers to foreign memory (C arrays, memory-mapped files, buffers of other libraries),
+* which must outlive it, or owns a buffer, when it is created by the library
+* as a temporary or an output, like a sequence container: copies of an owning view own a copy of its buffer.
+* Views of read-only memory have a const data type, like `ArrayView<const double>`, and give only const access.
+* Iterators are raw pointers, so that loops on views are compiled like loops on arrays.
+*
+* @tparam ValType The numeric data type of the values, const for read-only values.
+* @tparam Alloc The allocator of owned buffers, making the view compatible with
+* the `ContType<ValType, Alloc>` signatures of the library.
+*/
+template<typename ValType, typename Alloc = std::allocator<typename std::remove_const<ValType>::type>>
+class ArrayView
+{
+public:
+
+	typedef typename std::remove_const<ValType>::type value_type;
+	typedef Alloc allocator_type;
+	typedef size_t size_type;
+	typedef ValType* iterator;
+	typedef const value_type* const_iterator;
+
+	/**
+	* Create empty view.
+	*/
+	ArrayView() : _data(nullptr), _size(0) {}
+
+	/**
+	* Create view of foreign memory.
+	*
+	* @param data Pointer to the first value, to const values for a read-only view.
+	* @param size Number of values.
+	*/
+	ArrayView(ValType* data, size_t size)
+		: _data(data), _size(size)
+	{}
+
+	/**
+	* Create view of the values of a vector.
+	*
+	* @param x Input vector.
+	*/
+	template<typename VAlloc>
+	ArrayView(std::vector<value_type, VAlloc>& x)
+		: _data(x.data()), _size(x.size())
+	{}
+
+	/**
+	* Create read-only view of the values of a const vector.
+	*
+	* @param x Input vector.
+	*/
+	template<typename VAlloc, typename V = ValType, typename = typename std::enable_if<std::is_const<V>::value>::type>
+	ArrayView(const std::vector<value_type, VAlloc>& x)
+		: _data(x.data()), _size(x.size())
+	{}
+
+	/**
+	* Views of temporary vectors, which would not outlive them, are not allowed.
+	*/
+	template<typename VAlloc>
+	ArrayView(std::vector<value_type, VAlloc>&& x) = delete;
+
+	/**
+	* Create read-only view of the values of a view, which must outlive it.
+	*
+	* @param x Input view.
+	*/
+	template<typename V = ValType, typename = typename std::enable_if<std::is_const<V>::value>::type>
+	ArrayView(const ArrayView<value_type, Alloc>& x)
+		: _data(x._data), _size(x._size)
+	{}
+
+	/**
+	* Create read-only view of the values of a temporary view, taking its buffer if it owns it.
+	*
+	* @param x Input view.
+	*/
+	template<typename V = ValType, typename = typename std::enable_if<std::is_const<V>::value>::type>
+	ArrayView(ArrayView<value_type, Alloc>&& x)
+		: _owned(std::move(x._owned)), _data(x._data), _size(x._size)
+	{
+		x._data = nullptr, x._size = 0;
+	}
+
+	/**
+	* Create view owning a buffer of value-initialized values.
+	*
+	* @param size Number of values.
+	* @param value Value of all values.
+	* @param alloc Allocator of the buffer.
+	*/
+	explicit ArrayView(size_t size, const value_type& value = value_type(), const Alloc& alloc = Alloc())
+		: _owned(new std::vector<value_type, Alloc>(size, value, alloc))
+	{
+		attach();
+	}
+
+	/**
+	* Create view owning a copy of a range of values.
+	*
+	* @param first, last Range of values.
+	* @param alloc Allocator of the buffer.
+	*/
+	template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+	ArrayView(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+		: _owned(new std::vector<value_type, Alloc>(first, last, alloc))
+	{
+		attach();
+	}
+
+	/**
+	* Create view owning a copy of a list of values.
+	*
+	* @param values List of values.
+	*/
+	ArrayView(std::initializer_list<value_type> values)
+		: _owned(new std::vector<value_type, Alloc>(values))
+	{
+		attach();
+	}
+
+	/**
+	* Copy a view: a view of the same foreign memory, or a view owning a copy of the buffer.
+	*
+	* @param x Input view.
+	*/
+	ArrayView(const ArrayView& x)
+		: _owned(x._owned != nullptr ? new std::vector<value_type, Alloc>(*x._owned) : nullptr), _data(x._data), _size(x._size)
+	{
+		if (is_owner())
+			attach();
+	}
+
+	ArrayView(ArrayView&& x)
+		: _owned(std::move(x._owned)), _data(x._data), _size(x._size)
+	{
+		x._data = nullptr, x._size = 0;
+	}
+
+	ArrayView& operator=(ArrayView x)
+	{
+		_owned.swap(x._owned);
+		std::swap(_data, x._data);
+		std::swap(_size, x._size);
+		return *this;
+	}
+
+	size_t size() const { return _size; }
+
+	bool empty() const { return _size == 0; }
+
+	bool is_owner() const { return _owned != nullptr; }
+
+	Alloc get_allocator() const { return _owned != nullptr ? _owned->get_allocator() : Alloc(); }
+
+	const value_type* data() const { return _data; }
+
+	ValType* data() { return _data; }
+
+	iterator begin() { return _data; }
+
+	iterator end() { return _data + _size; }
+
+	const_iterator begin() const { return _data; }
+
+	const_iterator end() const { return _data + _size; }
+
+	ValType& operator[](size_t i) { return _data[i]; }
+
+	const value_type& operator[](size_t i) const { return _data[i]; }
+
+	const value_type& front() const { return _data[0]; }
+
+	const value_type& back() const { return _data[_size - 1]; }
+
+	/**
+	* Append a value, only for views owning their buffer.
+	*
+	* @param x Input value.
+	*/
+	void push_back(const value_type& x)
+	{
+		if (!is_owner())
+			throw std::logic_error("View of foreign memory can not be resized.");
+		_owned->push_back(x);
+		attach();
+	}
+
+protected:
+
+	template<typename, typename> friend class ArrayView;
+
+	void attach()
+	{
+		_data = _owned->data();
+		_size = _owned->size();
+	}
+
+	std::unique_ptr<std::vector<value_type, Alloc>> _owned;
+	ValType* _data;
+	size_t _size;
+};
+
+
+/**
+* Random access iterator on values spaced by a constant stride.
+*
+* @tparam ValType The data type of the values, possibly const.
+*/
+template<typename ValType>
+class StridedIterator
+{
+public:
+
+	typedef std::random_access_iterator_tag iterator_category;
+	typedef typename std::remove_const<ValType>::type value_type;
+	typedef std::ptrdiff_t difference_type;
+	typedef ValType* pointer;
+	typedef ValType& reference;
+
+	StridedIterator() : _ptr(nullptr), _stride(1) {}
+
+	StridedIterator(ValType* ptr, difference_type stride) : _ptr(ptr), _stride(stride) {}
+
+	operator StridedIterator<const ValType>() const { return StridedIterator<const ValType>(_ptr, _stride); }
+
+	ValType& operator*() const { return *_ptr; }
+
+	ValType* operator->() const { return _ptr; }
+
+	ValType& operator[](difference_type n) const { return _ptr[n * _stride]; }
+
+	StridedIterator& operator++() { _ptr += _stride; return *this; }
+
+	StridedIterator operator++(int) { StridedIterator it = *this; _ptr += _stride; return it; }
+
+	StridedIterator& operator--() { _ptr -= _stride; return *this; }
+
+	StridedIterator operator--(int) { StridedIterator it = *this; _ptr -= _stride; return it; }
+
+	StridedIterator& operator+=(difference_type n) { _ptr += n * _stride; return *this; }
+
+	StridedIterator& operator-=(difference_type n) { _ptr -= n * _stride; return *this; }
+
+	StridedIterator operator+(difference_type n) const { return StridedIterator(_ptr + n * _stride, _stride); }
+
+	StridedIterator operator-(difference_type n) const { return StridedIterator(_ptr - n * _stride, _stride); }
+
+	difference_type operator-(const StridedIterator& other) const { return (_ptr - other._ptr) / _stride; }
+
+	bool operator==(const StridedIterator& other) const { return _ptr == other._ptr; }
+
+	bool operator!=(const StridedIterator& other) const { return _ptr != other._ptr; }
+
+	bool operator<(const StridedIterator& other) const { return (other - *this) > 0; }
+
+	bool operator>(const StridedIterator& other) const { return other < *this; }
+
+	bool operator<=(const StridedIterator& other) const { return !(other < *this); }
+
+	bool operator>=(const StridedIterator& other) const { return !(*this < other); }
+
+protected:
+
+	ValType* _ptr;
+	difference_type _stride;
+};
+
+
+/**
+* Strided view of values, without copy, consumable by all functions of Maths.hpp and Stats.hpp,
+* like a column of a row-major matrix or a field of an array of structures.
+*
+* Like `ArrayView`, a strided view either refers to foreign memory, read-only for a const data type,
+* or owns a contiguous buffer, copied with the view.
+*
+* @tparam ValType The numeric data type of the values, const for read-only values.
+* @tparam Alloc The allocator of owned buffers.
+*/
+template<typename ValType, typename Alloc = std::allocator<typename std::remove_const<ValType>::type>>
+class StridedView
+{
+public:
+
+	typedef typename std::remove_const<ValType>::type value_type;
+	typedef Alloc allocator_type;
+	typedef size_t size_type;
+	typedef StridedIterator<ValType> iterator;
+	typedef StridedIterator<const value_type> const_iterator;
+
+	/**
+	* Create empty view.
+	*/
+	StridedView() : _data(nullptr), _size(0), _stride(1) {}
+
+	/**
+	* Create view of foreign memory.
+	*
+	* @param data Pointer to the first value, to const values for a read-only view.
+	* @param size Number of values.
+	* @param stride Number of values of type `ValType` between two consecutive values of the view.
+	*/
+	StridedView(ValType* data, size_t size, std::ptrdiff_t stride = 1)
+		: _data(data), _size(size), _stride(stride)
+	{
+		if (stride == 0)
+			throw std::invalid_argument("Stride must be non-zero.");
+	}
+
+	/**
+	* Create view owning a contiguous buffer of value-initialized values.
+	*
+	* @param size Number of values.
+	* @param value Value of all values.
+	* @param alloc Allocator of the buffer.
+	*/
+	explicit StridedView(size_t size, const value_type& value = value_type(), const Alloc& alloc = Alloc())
+		: _owned(new std::vector<value_type, Alloc>(size, value, alloc)), _stride(1)
+	{
+		attach();
+	}
+
+	/**
+	* Create view owning a contiguous copy of a range of values.
+	*
+	* @param first, last Range of values.
+	* @param alloc Allocator of the buffer.
+	*/
+	template<typename InputIt, typename = typename std::enable_if<!std::is_integral<InputIt>::value>::type>
+	StridedView(InputIt first, InputIt last, const Alloc& alloc = Alloc())
+		: _owned(new std::vector<value_type, Alloc>(first, last, alloc)), _stride(1)
+	{
+		attach();
+	}
+
+	/**
+	* Create view owning a contiguous copy of a list of values.
+	*
+	* @param values List of values.
+	*/
+	StridedView(std::initializer_list<value_type> values)
+		: _owned(new std::vector<value_type, Alloc>(values)), _stride(1)
+	{
+		attach();
+	}
+
+	/**
+	* Copy a view: a view of the same foreign memory, or a view owning a copy of the buffer.
+	*
+	* @param x Input view.
+	*/
+	StridedView(const StridedView& x)
+		: _owned(x._owned != nullptr ? new std::vector<value_type, Alloc>(*x._owned) : nullptr),
+		_data(x._data), _size(x._size), _stride(x._stride)
+	{
+		if (is_owner())
+			attach();
+	}
+
+	StridedView(StridedView&& x)
+		: _owned(std::move(x._owned)), _data(x._data), _size(x._size), _stride(x._stride)
+	{
+		x._data = nullptr, x._size = 0;
+	}
+
+	StridedView& operator=(StridedView x)
+	{
+		_owned.swap(x._owned);
+		std::swap(_data, x._data);
+		std::swap(_size, x._size);
+		std::swap(_stride, x._stride);
+		return *this;
+	}
+
+	size_t size() const { return _size; }
+
+	bool empty() const { return _size == 0; }
+
+	bool is_owner() const { return _owned != nullptr; }
+
+	Alloc get_allocator() const { return _owned != nullptr ? _owned->get_allocator() : Alloc(); }
+
+	bool is_contiguous() const { return _stride == 1; }
+
+	std::ptrdiff_t stride() const { return _stride; }
+
+	const value_type* data() const { return _data; }
+
+	ValType* data() { return _data; }
+
+	iterator begin() { return iterator(_data, _stride); }
+
+	iterator end() { return iterator(_data + _size * _stride, _stride); }
+
+	const_iterator begin() const { return const_iterator(_data, _stride); }
+
+	const_iterator end() const { return const_iterator(_data + _size * _stride, _stride); }
+
+	ValType& operator[](size_t i) { return _data[i * _stride]; }
+
+	const value_type& operator[](size_t i) const { return _data[i * _stride]; }
+
+	const value_type& front() const { return _data[0]; }
+
+	const value_type& back() const { return _data[(_size - 1) * _stride]; }
+
+	/**
+	* Read-only contiguous view of the same values, only for contiguous views.
+	*/
+	ArrayView<const value_type, Alloc> contiguous() const
+	{
+		if (!is_contiguous())
+			throw std::logic_error("View is not contiguous.");
+		return ArrayView<const value_type, Alloc>(_data, _size);
+	}
+
+	/**
+	* Append a value, only for views owning their buffer.
+	*
+	* @param x Input value.
+	*/
+	void push_back(const value_type& x)
+	{
+		if (!is_owner())
+			throw std::logic_error("View of foreign memory can not be resized.");
+		_owned->push_back(x);
+		attach();
+	}
+
+protected:
+
+	void attach()
+	{
+		_data = _owned->data();
+		_size = _owned->size();
+	}
+
+	std::unique_ptr<std::vector<value_type, Alloc>> _owned;
+	ValType* _data;
+	size_t _size;
+	std::ptrdiff_t _stride;
+};
+
+
+/**
+* Contiguous view of `size` values starting at `data`, read-only for a pointer to const values.
+*/
+template<typename ValType>
+ArrayView<ValType> make_view(ValType* data, size_t size)
+{
+	return ArrayView<ValType>(data, size);
+}
+
+/**
+* Strided view of `size` values starting at `data`, spaced by `stride` values.
+*/
+template<typename ValType>
+StridedView<ValType> make_view(ValType* data, size_t size, std::ptrdiff_t stride)
+{
+	return StridedView<ValType>(data, size, stride);
+}
+
+/**
+* Contiguous view of a range of pointers.
+*/
+template<typename ValType>
+ArrayView<ValType> make_view(ValType* first, ValType* last)
+{
+	return ArrayView<ValType>(first, static_cast<size_t>(last - first));
+}
+
+/**
+* Boolean checking if an iterator is an iterator of `std::vector`, whose values are contiguous.
+* Iterators of vectors of any allocator are detected with libstdc++, libc++ and MSVC,
+* and only iterators of vectors of `std::allocator` with other standard libraries.
+*/
+template<typename It>
+struct is_vector_iterator : std::integral_constant<bool,
+	!std::is_same<typename std::iterator_traits<It>::value_type, bool>::value && (
+		std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator>::value
+		|| std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::const_iterator>::value
+	)
+> {};
+
+#if defined(__GLIBCXX__)
+template<typename Ptr, typename ValType, typename Alloc>
+struct is_vector_iterator<__gnu_cxx::__normal_iterator<Ptr, std::vector<ValType, Alloc>>> : std::true_type {};
+#elif defined(_LIBCPP_VERSION)
+template<typename Ptr>
+struct is_vector_iterator<std::__wrap_iter<Ptr>> : std::true_type {};
+#elif defined(_MSC_VER)
+template<typename VecVal>
+struct is_vector_iterator<std::_Vector_iterator<VecVal>> : std::true_type {};
+
+template<typename VecVal>
+struct is_vector_iterator<std::_Vector_const_iterator<VecVal>> : std::true_type {};
+#endif
+
+/**
+* View of a range of iterators of contiguous values, without copy.
+*/
+template<typename It, bool = std::is_pointer<It>::value || is_vector_iterator<It>::value>
+struct RangeView
+{
+	typedef ArrayView<typename std::remove_reference<typename std::iterator_traits<It>::reference>::type> type;
+
+	static type make(It first, It last)
+	{
+		return type(first == last ? nullptr : &*first, static_cast<size_t>(last - first));
+	}
+};
+
+/**
+* View of a range of other iterators, owning a contiguous copy of its values.
+*/
+template<typename It>
+struct RangeView<It, false>
+{
+	typedef ArrayView<const typename std::iterator_traits<It>::value_type> type;
+
+	static type make(It first, It last)
+	{
+		return type(first, last);
+	}
+};
+
+/**
+* Contiguous view of a range of iterators: a view without copy for iterators of vectors,
+* read-only for const iterators, and a read-only view owning a contiguous copy of the values otherwise,
+* for instance for `std::deque` or ring buffers.
+*/
+template<typename It>
+typename RangeView<It>::type make_view(It first, It last)
+{
+	return RangeView<It>::make(first, last);
+}
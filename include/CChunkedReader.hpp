@@ -0,0 +1,302 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <iostream>
+#include <fstream>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "CArrayView.hpp"
+#include "CCsvReader.hpp"
+
+
+/**
+* Format of the values read by `ChunkedReader`.
+*/
+enum StreamFormat
+{
+	STREAM_BINARY, ///< Values in native binary representation.
+	STREAM_TEXT ///< Numbers in text, separated by whitespaces or commas.
+};
+
+
+/**
+* Reader of a file or a stream by fixed-size chunks, for data larger than memory.
+*
+* A prefetch thread reads the next chunk into a second buffer while the current chunk is consumed,
+* so that reading and computing overlap, with a memory footprint of two chunks.
+* Chunks contain whole rows of `n_cols` values, stored row-major,
+* which can be consumed by mergeable accumulators of the library
+* (`RunningMoments`, `RunningRegression`, `LogHistogram`, `GroupBy`), for instance by `summarize_stream`,
+* or by the functions of Stats.hpp through views.
+* An error of the prefetch thread is thrown by `next` when the failed chunk is consumed,
+* after the chunks read before it.
+*
+* @tparam ValType The numeric data type of the values.
+*/
+template<typename ValType = double>
+class ChunkedReader
+{
+public:
+
+	/**
+	* Open a file, or the standard input for the path "-".
+	*
+	* @param path Path of the input file.
+	* @param format Format of the values.
+	* @param chunk_rows Number of rows by chunk.
+	* @param n_cols Number of values by row.
+	*/
+	explicit ChunkedReader(
+		const std::string& path, StreamFormat format = STREAM_BINARY, size_t chunk_rows = 1 << 20, size_t n_cols = 1
+	)
+	{
+		if (path == "-")
+			_is = &std::cin;
+		else
+		{
+			std::ios::openmode mode = format == STREAM_BINARY ? std::ios::in | std::ios::binary : std::ios::in;
+			_file.reset(new std::ifstream(path.c_str(), mode));
+			if (!*_file)
+				throw std::runtime_error("File can not be opened: " + path);
+			_is = _file.get();
+		}
+		start(format, chunk_rows, n_cols);
+	}
+
+	/**
+	* Read a stream, which must outlive the reader.
+	*
+	* @param is Input stream.
+	* @param format Format of the values.
+	* @param chunk_rows Number of rows by chunk.
+	* @param n_cols Number of values by row.
+	*/
+	explicit ChunkedReader(
+		std::istream& is, StreamFormat format = STREAM_BINARY, size_t chunk_rows = 1 << 20, size_t n_cols = 1
+	)
+		: _is(&is)
+	{
+		start(format, chunk_rows, n_cols);
+	}
+
+	~ChunkedReader()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_stop = true;
+		}
+		_cond.notify_all();
+		_thread.join();
+	}
+
+	size_t get_n_cols() const { return _n_cols; }
+
+	/**
+	* Number of rows of the chunks consumed so far.
+	*/
+	size_t get_rows_read() const { return _rows_read; }
+
+	/**
+	* Get the next chunk, releasing the previous one to the prefetch thread.
+	*
+	* @param chunk Output view of the values of the chunk, valid until the next call.
+	*
+	* @return Boolean checking if a chunk was read, false at the end of the stream.
+	*/
+	bool next(ArrayView<ValType>& chunk)
+	{
+		std::unique_lock<std::mutex> lock(_mutex);
+		if (_is_held)
+		{
+			_ready[_read] = false;
+			_read ^= 1;
+			_is_held = false;
+			_cond.notify_all();
+		}
+		_cond.wait(lock, [this]() { return _ready[_read]; });
+		if (_errors[_read])
+			std::rethrow_exception(_errors[_read]);
+		if (_buffers[_read].empty())
+			return false;
+
+		_is_held = true;
+		_rows_read += _buffers[_read].size() / _n_cols;
+		chunk = ArrayView<ValType>(_buffers[_read].data(), _buffers[_read].size());
+		return true;
+	}
+
+	/**
+	* Call a function on each chunk, until the end of the stream.
+	*
+	* @tparam Func The type of the function, called as `func(chunk)` with an `ArrayView<ValType>`.
+	*
+	* @param func Function called on each chunk.
+	*
+	* @return Number of rows read.
+	*/
+	template<typename Func>
+	size_t for_each(Func func)
+	{
+		ArrayView<ValType> chunk;
+		while (next(chunk))
+			func(chunk);
+		return _rows_read;
+	}
+
+protected:
+
+	ChunkedReader(const ChunkedReader&);
+	ChunkedReader& operator=(const ChunkedReader&);
+
+	void start(StreamFormat format, size_t chunk_rows, size_t n_cols)
+	{
+		if (chunk_rows == 0 || n_cols == 0)
+			throw std::invalid_argument("Chunks must have at least one row and one column.");
+
+		_format = format;
+		_chunk_size = chunk_rows * n_cols;
+		_n_cols = n_cols;
+		_rows_read = 0;
+		_read = 0, _write = 0;
+		_ready[0] = _ready[1] = false;
+		_is_held = false, _stop = false;
+		_thread = std::thread(&ChunkedReader::prefetch, this);
+	}
+
+	/**
+	* Loop of the prefetch thread, filling free buffers until the end of the stream,
+	* marked by an empty buffer.
+	*/
+	void prefetch()
+	{
+		bool is_end = false;
+		while (!is_end)
+		{
+			{
+				std::unique_lock<std::mutex> lock(_mutex);
+				_cond.wait(lock, [this]() { return _stop || !_ready[_write]; });
+				if (_stop)
+					return;
+			}
+
+			std::vector<ValType>& buffer = _buffers[_write];
+			try
+			{
+				if (_format == STREAM_BINARY)
+					read_binary(buffer);
+				else
+					read_text(buffer);
+			}
+			catch (...)
+			{
+				_errors[_write] = std::current_exception();
+				buffer.clear();
+			}
+			is_end = buffer.empty();
+
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_ready[_write] = true;
+				_write ^= 1;
+			}
+			_cond.notify_all();
+		}
+	}
+
+	/**
+	* Read whole rows of binary values, ignoring a truncated last row.
+	*/
+	void read_binary(std::vector<ValType>& buffer)
+	{
+		buffer.resize(_chunk_size);
+		_is->read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(_chunk_size * sizeof(ValType)));
+		size_t n = static_cast<size_t>(_is->gcount()) / sizeof(ValType);
+		buffer.resize(n / _n_cols * _n_cols);
+	}
+
+	/**
+	* Read whole rows of text values, carrying a truncated token and a truncated row to the next chunk.
+	*/
+	void read_text(std::vector<ValType>& buffer)
+	{
+		const size_t block_size = 1 << 16;
+		buffer.swap(_carry_values);
+		_carry_values.clear();
+		std::vector<char> text;
+		bool is_end = false;
+		while (buffer.size() < _chunk_size && !is_end)
+		{
+			text.assign(_carry_text.begin(), _carry_text.end());
+			size_t n_carry = text.size();
+			text.resize(n_carry + block_size + 1);
+			_is->read(text.data() + n_carry, block_size);
+			size_t n = n_carry + static_cast<size_t>(_is->gcount());
+			is_end = n == n_carry;
+
+			size_t n_parsed = n;
+			if (!is_end)
+				while (n_parsed > 0 && !is_separator(text[n_parsed - 1]))
+					n_parsed--;
+			_carry_text.assign(text.begin() + n_parsed, text.begin() + n);
+			text[n_parsed] = '\0';
+			parse(text.data(), text.data() + n_parsed, buffer);
+		}
+
+		bool is_last = is_end && buffer.size() <= _chunk_size;
+		size_t n_rows = std::min(buffer.size(), _chunk_size) / _n_cols;
+		if (!is_last)
+			_carry_values.assign(buffer.begin() + n_rows * _n_cols, buffer.end());
+		buffer.resize(n_rows * _n_cols);
+	}
+
+	static bool is_separator(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',';
+	}
+
+	/**
+	* Parse separated tokens of a text in the "C" locale, as `CsvReader`, non-numeric tokens giving NaN.
+	*/
+	static void parse(const char* first, const char* last, std::vector<ValType>& values)
+	{
+		while (first < last)
+		{
+			while (first < last && is_separator(*first))
+				++first;
+			if (first == last)
+				break;
+			const char* token_end = first;
+			while (token_end < last && !is_separator(*token_end))
+				++token_end;
+			values.push_back(static_cast<ValType>(CsvReader::parse_field(first, token_end)));
+			first = token_end;
+		}
+	}
+
+	std::istream* _is;
+	std::unique_ptr<std::ifstream> _file;
+	StreamFormat _format;
+	size_t _chunk_size, _n_cols, _rows_read;
+
+	std::vector<ValType> _buffers[2];
+	bool _ready[2];
+	unsigned int _read, _write;
+	bool _is_held, _stop;
+	std::exception_ptr _errors[2];
+
+	std::vector<ValType> _carry_values;
+	std::vector<char> _carry_text;
+
+	std::thread _thread;
+	std::mutex _mutex;
+	std::condition_variable _cond;
+};
@@ -0,0 +1,299 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <functional>
+#include <algorithm>
+#include "CArrayView.hpp"
+#include "CMappedFile.hpp"
+
+
+/**
+* Code of the numeric data types storable in column files.
+*/
+template<typename ValType>
+struct ColumnTypeCode;
+
+template<> struct ColumnTypeCode<int32_t> { static const uint32_t value = 1; };
+template<> struct ColumnTypeCode<int64_t> { static const uint32_t value = 2; };
+template<> struct ColumnTypeCode<uint32_t> { static const uint32_t value = 3; };
+template<> struct ColumnTypeCode<uint64_t> { static const uint32_t value = 4; };
+template<> struct ColumnTypeCode<float> { static const uint32_t value = 5; };
+template<> struct ColumnTypeCode<double> { static const uint32_t value = 6; };
+
+
+/**
+* Layout of column files, self-describing binary files of typed columns with the same number of rows.
+*
+* A file starts with a header (magic "SSCF", version, number of columns, number of rows),
+* followed by a directory of columns (name, type code, offset),
+* followed by the values of each column, stored contiguously in native byte order,
+* each column starting at an offset aligned on 64 bytes (a cache line).
+*/
+struct ColumnFileLayout
+{
+	static const uint32_t magic = 0x46435353; // "SSCF"
+	static const uint32_t version = 1;
+	static const size_t alignment = 64;
+	static const size_t name_size = 48;
+
+	struct Header
+	{
+		uint32_t magic, version, n_columns, reserved;
+		uint64_t n_rows;
+	};
+
+	struct Entry
+	{
+		char name[name_size];
+		uint32_t type, reserved;
+		uint64_t offset;
+	};
+
+	static size_t align(size_t offset)
+	{
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+};
+
+
+/**
+* Writer of column files.
+*
+* Columns are registered by reference, then written in one pass by `write`,
+* without copying containers in memory: registered containers must outlive the call to `write`.
+*/
+class ColumnFileWriter
+{
+public:
+
+	/**
+	* Register a column.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param name Name of the column, with less than 48 characters.
+	* @param x Input sequence container, whose value type is one of the types of `ColumnTypeCode`.
+	*/
+	template<typename ContType>
+	void add_column(const std::string& name, const ContType& x)
+	{
+		typedef typename ContType::value_type ValType;
+		if (name.empty() || name.size() >= ColumnFileLayout::name_size)
+			throw std::invalid_argument("Name of column must have between 1 and 47 characters.");
+		for (const auto& c : _columns)
+			if (c.name == name)
+				throw std::invalid_argument("Name of column is already used.");
+		if (!_columns.empty() && x.size() != _n_rows)
+			throw std::invalid_argument("Columns have not the same size.");
+
+		_n_rows = x.size();
+		Column c;
+		c.name = name;
+		c.type = ColumnTypeCode<ValType>::value;
+		c.value_size = sizeof(ValType);
+		c.write = [&x](std::ostream& os) {
+			const size_t buffer_size = 1 << 14;
+			std::vector<ValType> buffer;
+			buffer.reserve(buffer_size);
+			for (const auto& e : x)
+			{
+				buffer.push_back(e);
+				if (buffer.size() == buffer_size)
+				{
+					os.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(ValType));
+					buffer.clear();
+				}
+			}
+			os.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(ValType));
+		};
+		_columns.push_back(c);
+	}
+
+	/**
+	* Write registered columns into a file.
+	*
+	* @param path Path of the output file.
+	*/
+	void write(const std::string& path) const
+	{
+		std::ofstream os(path.c_str(), std::ios::binary | std::ios::trunc);
+		if (!os)
+			throw std::runtime_error("Column file can not be created: " + path);
+
+		ColumnFileLayout::Header header = {
+			ColumnFileLayout::magic, ColumnFileLayout::version, static_cast<uint32_t>(_columns.size()), 0, _n_rows
+		};
+		std::vector<ColumnFileLayout::Entry> entries(_columns.size());
+		size_t offset = ColumnFileLayout::align(sizeof(header) + entries.size() * sizeof(ColumnFileLayout::Entry));
+		for (size_t i = 0; i < _columns.size(); ++i)
+		{
+			std::memset(&entries[i], 0, sizeof(ColumnFileLayout::Entry));
+			std::memcpy(entries[i].name, _columns[i].name.c_str(), _columns[i].name.size());
+			entries[i].type = _columns[i].type;
+			entries[i].offset = offset;
+			offset = ColumnFileLayout::align(offset + _n_rows * _columns[i].value_size);
+		}
+
+		os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		os.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ColumnFileLayout::Entry));
+		for (size_t i = 0; i < _columns.size(); ++i)
+		{
+			pad(os, entries[i].offset);
+			_columns[i].write(os);
+		}
+		if (!os)
+			throw std::runtime_error("Column file can not be written: " + path);
+	}
+
+protected:
+
+	struct Column
+	{
+		std::string name;
+		uint32_t type;
+		size_t value_size;
+		std::function<void(std::ostream&)> write;
+	};
+
+	static void pad(std::ostream& os, uint64_t offset)
+	{
+		static const char zeros[ColumnFileLayout::alignment] = {};
+		uint64_t pos = static_cast<uint64_t>(os.tellp());
+		os.write(zeros, static_cast<std::streamsize>(offset - pos));
+	}
+
+	std::vector<Column> _columns;
+	uint64_t _n_rows = 0;
+};
+
+
+/**
+* Reader of column files, giving views of columns without copy.
+*
+* The file is a `MappedFile`: on POSIX systems, it is memory-mapped with a sequential access hint,
+* so that columns are paged in by the kernel while they are consumed.
+* Views are valid as long as the reader is alive.
+*/
+class ColumnFile
+{
+public:
+
+	/**
+	* Open a column file.
+	*
+	* @param path Path of the input file.
+	*/
+	explicit ColumnFile(const std::string& path)
+		: _file(path)
+	{
+		parse();
+	}
+
+	size_t rows() const { return static_cast<size_t>(_header.n_rows); }
+
+	size_t cols() const { return _entries.size(); }
+
+	/**
+	* Names of columns, in the order of the file.
+	*/
+	std::vector<std::string> get_names() const
+	{
+		std::vector<std::string> names;
+		for (const auto& e : _entries)
+			names.push_back(e.name);
+		return names;
+	}
+
+	/**
+	* Check if a column exists.
+	*
+	* @param name Name of the column.
+	*/
+	bool has_column(const std::string& name) const
+	{
+		return find(name) != nullptr;
+	}
+
+	/**
+	* Read-only view of the values of a column, without copy.
+	*
+	* @tparam ValType The numeric data type of the column, as written.
+	*
+	* @param name Name of the column.
+	*/
+	template<typename ValType>
+	ArrayView<const ValType> column(const std::string& name) const
+	{
+		const ColumnFileLayout::Entry* entry = find(name);
+		if (entry == nullptr)
+			throw std::invalid_argument("Column is not in file: " + name);
+		if (entry->type != ColumnTypeCode<ValType>::value)
+			throw std::invalid_argument("Column has not the requested type: " + name);
+		return ArrayView<const ValType>(reinterpret_cast<const ValType*>(_file.data() + entry->offset), rows());
+	}
+
+protected:
+
+	static size_t type_size(uint32_t type)
+	{
+		switch (type)
+		{
+		case ColumnTypeCode<int32_t>::value:
+		case ColumnTypeCode<uint32_t>::value:
+		case ColumnTypeCode<float>::value:
+			return 4;
+		case ColumnTypeCode<int64_t>::value:
+		case ColumnTypeCode<uint64_t>::value:
+		case ColumnTypeCode<double>::value:
+			return 8;
+		default:
+			return 0;
+		}
+	}
+
+	void parse()
+	{
+		if (_file.size() < sizeof(ColumnFileLayout::Header))
+			throw std::invalid_argument("File is not a column file.");
+		std::memcpy(&_header, _file.data(), sizeof(_header));
+		if (_header.magic != ColumnFileLayout::magic)
+			throw std::invalid_argument("File is not a column file.");
+		if (_header.version != ColumnFileLayout::version)
+			throw std::invalid_argument("Version of column file is not supported.");
+
+		// sizes are checked by divisions, which do not overflow with corrupt headers
+		if (_header.n_columns > (_file.size() - sizeof(_header)) / sizeof(ColumnFileLayout::Entry))
+			throw std::invalid_argument("Column file is truncated.");
+		size_t dir_end = sizeof(_header) + _header.n_columns * sizeof(ColumnFileLayout::Entry);
+		_entries.resize(_header.n_columns);
+		std::memcpy(_entries.data(), _file.data() + sizeof(_header), _entries.size() * sizeof(ColumnFileLayout::Entry));
+
+		for (auto& e : _entries)
+		{
+			e.name[ColumnFileLayout::name_size - 1] = '\0';
+			size_t value_size = type_size(e.type);
+			if (value_size == 0)
+				throw std::invalid_argument("Type of column is not supported.");
+			if (e.offset % value_size != 0 || e.offset < dir_end || e.offset > _file.size()
+				|| _header.n_rows > (_file.size() - e.offset) / value_size)
+				throw std::invalid_argument("Column file is truncated.");
+		}
+	}
+
+	const ColumnFileLayout::Entry* find(const std::string& name) const
+	{
+		for (const auto& e : _entries)
+			if (name == e.name)
+				return &e;
+		return nullptr;
+	}
+
+	MappedFile _file;
+	ColumnFileLayout::Header _header;
+	std::vector<ColumnFileLayout::Entry> _entries;
+};
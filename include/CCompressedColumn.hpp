@@ -0,0 +1,492 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include <intrin.h>
+#endif
+
+
+/**
+* Column of numeric values compressed by blocks, answering range statistics from block summaries.
+*
+* Values are compressed by blocks of fixed size into a bit stream:
+* floating-point values with the XOR encoding of Gorilla (each value is XORed with the previous one,
+* and only the meaningful bits are stored), integer values with frame-of-reference bit packing
+* (each value is stored as its offset to the minimum of the block, on the bit width of the range of the block).
+* Each block keeps a summary (count, minimum, maximum, sum and sum of squared deviations),
+* so that range statistics merge the summaries of full blocks and only decompress the blocks at the edges.
+* Values pushed after the last full block are kept uncompressed.
+*
+* @tparam ValType The numeric data type of the values.
+*
+* @see [Gorilla: A Fast, Scalable, In-Memory Time Series Database](https://www.vldb.org/pvldb/vol8/p1816-teller.pdf)
+*/
+template<typename ValType>
+class CompressedColumn
+{
+public:
+
+	/**
+	* Summary of values, mergeable.
+	*/
+	struct Summary
+	{
+		size_t count;
+		double min, max, sum, m2;
+
+		void merge(const Summary& other)
+		{
+			if (other.count == 0)
+				return;
+			if (count > 0)
+			{
+				double delta = other.sum / other.count - sum / count;
+				m2 += other.m2 + delta * delta * count * other.count / (count + other.count);
+			}
+			else
+				m2 = other.m2;
+			count += other.count;
+			sum += other.sum;
+			min = std::min(min, other.min);
+			max = std::max(max, other.max);
+		}
+	};
+
+	/**
+	* Create empty column.
+	*
+	* @param block_size Number of values by block.
+	*/
+	explicit CompressedColumn(size_t block_size = 1024)
+		: _block_size(block_size), _n_bits(0)
+	{
+		if (block_size == 0)
+			throw std::invalid_argument("Block size must be positive.");
+	}
+
+	/**
+	* Create column compressing the values of a container.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param block_size Number of values by block.
+	*/
+	template<typename ContType, typename = typename std::enable_if<!std::is_arithmetic<ContType>::value>::type>
+	explicit CompressedColumn(const ContType& x, size_t block_size = 1024)
+		: CompressedColumn(block_size)
+	{
+		append(x);
+	}
+
+	/**
+	* Push a value, compressing a block when it is full.
+	*
+	* @param x Input value.
+	*/
+	void push(ValType x)
+	{
+		_tail.push_back(x);
+		if (_tail.size() == _block_size)
+		{
+			compress_block(_tail);
+			_tail.clear();
+		}
+	}
+
+	/**
+	* Push the values of a container.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*/
+	template<typename ContType>
+	void append(const ContType& x)
+	{
+		for (const auto& e : x)
+			push(static_cast<ValType>(e));
+	}
+
+	size_t size() const { return _blocks.size() * _block_size + _tail.size(); }
+
+	size_t get_block_size() const { return _block_size; }
+
+	size_t get_block_count() const { return _blocks.size(); }
+
+	/**
+	* Number of bytes of compressed values, block summaries and uncompressed tail.
+	*/
+	size_t get_memory_size() const
+	{
+		return _bits.size() * sizeof(uint64_t) + _blocks.size() * sizeof(Block) + _tail.size() * sizeof(ValType);
+	}
+
+	/**
+	* Decompress a range of values.
+	*
+	* @param first, last Range of indices of values.
+	*/
+	std::vector<ValType> decompress(size_t first, size_t last) const
+	{
+		check_range(first, last);
+		std::vector<ValType> x;
+		x.reserve(last - first);
+		std::vector<ValType> block;
+		while (first < last)
+		{
+			size_t b = first / _block_size, i = first % _block_size;
+			size_t n = std::min(last - first, _block_size - i);
+			if (b < _blocks.size())
+			{
+				decompress_block(b, block);
+				x.insert(x.end(), block.begin() + i, block.begin() + i + n);
+			}
+			else
+				x.insert(x.end(), _tail.begin() + i, _tail.begin() + i + n);
+			first += n;
+		}
+		return x;
+	}
+
+	/**
+	* Decompress all values.
+	*/
+	std::vector<ValType> decompress() const
+	{
+		return decompress(0, size());
+	}
+
+	/**
+	* Summary of a range of values, merging the summaries of full blocks
+	* and decompressing only the blocks at the edges of the range.
+	*
+	* @param first, last Range of indices of values.
+	*/
+	Summary summary(size_t first, size_t last) const
+	{
+		check_range(first, last);
+		Summary s = empty_summary();
+		std::vector<ValType> block;
+		while (first < last)
+		{
+			size_t b = first / _block_size, i = first % _block_size;
+			size_t n = std::min(last - first, _block_size - i);
+			if (b < _blocks.size() && n == _block_size)
+				s.merge(_blocks[b].summary);
+			else if (b < _blocks.size())
+			{
+				decompress_block(b, block);
+				s.merge(summarize(block.begin() + i, block.begin() + i + n));
+			}
+			else
+				s.merge(summarize(_tail.begin() + i, _tail.begin() + i + n));
+			first += n;
+		}
+		return s;
+	}
+
+	double sum(size_t first, size_t last) const
+	{
+		return summary(first, last).sum;
+	}
+
+	double min(size_t first, size_t last) const
+	{
+		if (first >= last)
+			throw std::invalid_argument("Range has not enough values for min.");
+		return summary(first, last).min;
+	}
+
+	double max(size_t first, size_t last) const
+	{
+		if (first >= last)
+			throw std::invalid_argument("Range has not enough values for max.");
+		return summary(first, last).max;
+	}
+
+	/**
+	* Arithmetic mean of a range of values.
+	*
+	* @param first, last Range of indices of values.
+	*/
+	double mean(size_t first, size_t last) const
+	{
+		if (first >= last)
+			throw std::invalid_argument("Range has not enough values for mean.");
+		Summary s = summary(first, last);
+		return s.sum / s.count;
+	}
+
+	/**
+	* Variance of a range of values, as computed by `Stats::var`.
+	*
+	* @param first, last Range of indices of values.
+	* @param ddof Degree of freedom.
+	*/
+	double var(size_t first, size_t last, size_t ddof = 0) const
+	{
+		if (first >= last || last - first <= 1)
+			throw std::invalid_argument("Range has not enough values for var.");
+		if (last - first - ddof == 0)
+			throw std::invalid_argument("Size minus degree of freedom is 0.");
+		return summary(first, last).m2 / (last - first - ddof);
+	}
+
+	/**
+	* Standard deviation of a range of values, as computed by `Stats::std`.
+	*
+	* @param first, last Range of indices of values.
+	* @param ddof Degree of freedom.
+	*/
+	double std(size_t first, size_t last, size_t ddof = 0) const
+	{
+		return std::sqrt(var(first, last, ddof));
+	}
+
+protected:
+
+	struct Block
+	{
+		size_t bit_offset;
+		ValType base;
+		unsigned int width;
+		Summary summary;
+	};
+
+	static Summary empty_summary()
+	{
+		Summary s = { 0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity(), 0.0, 0.0 };
+		return s;
+	}
+
+	template<typename InputIt>
+	static Summary summarize(InputIt first, InputIt last)
+	{
+		Summary s = empty_summary();
+		for (InputIt it = first; it != last; ++it)
+		{
+			double e = static_cast<double>(*it);
+			s.count++;
+			s.sum += e;
+			s.min = std::min(s.min, e);
+			s.max = std::max(s.max, e);
+		}
+		if (s.count > 0)
+		{
+			double mean = s.sum / s.count;
+			for (InputIt it = first; it != last; ++it)
+				s.m2 += (static_cast<double>(*it) - mean) * (static_cast<double>(*it) - mean);
+		}
+		return s;
+	}
+
+	void check_range(size_t first, size_t last) const
+	{
+		if (first > last || last > size())
+			throw std::invalid_argument("Range is out of the column.");
+	}
+
+	// --- Bit stream --- //
+
+	void write_bits(uint64_t value, unsigned int n)
+	{
+		if (n == 0)
+			return;
+		if (n < 64)
+			value &= (uint64_t(1) << n) - 1;
+		size_t word = _n_bits / 64;
+		unsigned int shift = _n_bits % 64;
+		if (word >= _bits.size())
+			_bits.push_back(0);
+		_bits[word] |= value << shift;
+		if (shift + n > 64)
+			_bits.push_back(value >> (64 - shift));
+		_n_bits += n;
+	}
+
+	uint64_t read_bits(size_t& pos, unsigned int n) const
+	{
+		if (n == 0)
+			return 0;
+		size_t word = pos / 64;
+		unsigned int shift = pos % 64;
+		uint64_t value = _bits[word] >> shift;
+		if (shift + n > 64)
+			value |= _bits[word + 1] << (64 - shift);
+		pos += n;
+		return n < 64 ? value & ((uint64_t(1) << n) - 1) : value;
+	}
+
+	/**
+	* Number of leading zero bits, 64 for 0.
+	*/
+	static unsigned int leading_zeros(uint64_t x)
+	{
+		if (x == 0)
+			return 64;
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned int>(__builtin_clzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long i;
+		_BitScanReverse64(&i, x);
+		return 63 - static_cast<unsigned int>(i);
+#else
+		// Branchless binary search: shift the highest set bit into the top position.
+		unsigned int n = 0, s;
+		s = (x <= 0x00000000FFFFFFFFull) << 5; n += s; x <<= s;
+		s = (x <= 0x0000FFFFFFFFFFFFull) << 4; n += s; x <<= s;
+		s = (x <= 0x00FFFFFFFFFFFFFFull) << 3; n += s; x <<= s;
+		s = (x <= 0x0FFFFFFFFFFFFFFFull) << 2; n += s; x <<= s;
+		s = (x <= 0x3FFFFFFFFFFFFFFFull) << 1; n += s; x <<= s;
+		s = (x <= 0x7FFFFFFFFFFFFFFFull); n += s;
+		return n;
+#endif
+	}
+
+	/**
+	* Number of trailing zero bits, 64 for 0.
+	*/
+	static unsigned int trailing_zeros(uint64_t x)
+	{
+		if (x == 0)
+			return 64;
+#if defined(__GNUC__) || defined(__clang__)
+		return static_cast<unsigned int>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long i;
+		_BitScanForward64(&i, x);
+		return static_cast<unsigned int>(i);
+#else
+		// Isolate the lowest set bit, whose position is given by its leading zeros.
+		return 63 - leading_zeros(x & (~x + 1));
+#endif
+	}
+
+	// --- Codecs --- //
+
+	void compress_block(const std::vector<ValType>& x)
+	{
+		Block block;
+		block.bit_offset = _n_bits;
+		block.summary = summarize(x.begin(), x.end());
+		block.base = x[0];
+		block.width = 0;
+		encode(x, block, std::is_floating_point<ValType>());
+		_blocks.push_back(block);
+	}
+
+	void decompress_block(size_t b, std::vector<ValType>& x) const
+	{
+		x.resize(_block_size);
+		decode(_blocks[b], x, std::is_floating_point<ValType>());
+	}
+
+	/**
+	* XOR encoding: a bit 0 for a value equal to the previous one, otherwise a bit 1 followed by
+	* a bit 0 and the meaningful bits of the XOR in the window of the previous one if they fit in,
+	* or by a bit 1, the numbers of leading zeros and of meaningful bits (6 bits each), and the meaningful bits.
+	*/
+	void encode(const std::vector<ValType>& x, Block&, std::true_type)
+	{
+		uint64_t prev = to_bits(x[0]);
+		write_bits(prev, 64);
+		unsigned int prev_lead = 65, prev_len = 0;
+		for (size_t i = 1; i < x.size(); ++i)
+		{
+			uint64_t bits = to_bits(x[i]);
+			uint64_t xr = bits ^ prev;
+			prev = bits;
+			if (xr == 0)
+			{
+				write_bits(0, 1);
+				continue;
+			}
+			write_bits(1, 1);
+			unsigned int lead = std::min(leading_zeros(xr), 63u), trail = trailing_zeros(xr);
+			if (prev_lead <= lead && 64 - prev_lead - prev_len <= trail)
+			{
+				write_bits(0, 1);
+				write_bits(xr >> (64 - prev_lead - prev_len), prev_len);
+			}
+			else
+			{
+				unsigned int len = 64 - lead - trail;
+				write_bits(1, 1);
+				write_bits(lead, 6);
+				write_bits(len - 1, 6);
+				write_bits(xr >> trail, len);
+				prev_lead = lead, prev_len = len;
+			}
+		}
+	}
+
+	void decode(const Block& block, std::vector<ValType>& x, std::true_type) const
+	{
+		size_t pos = block.bit_offset;
+		uint64_t prev = read_bits(pos, 64);
+		x[0] = from_bits(prev);
+		unsigned int lead = 0, len = 0;
+		for (size_t i = 1; i < x.size(); ++i)
+		{
+			if (read_bits(pos, 1) == 1)
+			{
+				if (read_bits(pos, 1) == 1)
+				{
+					lead = static_cast<unsigned int>(read_bits(pos, 6));
+					len = static_cast<unsigned int>(read_bits(pos, 6)) + 1;
+				}
+				prev ^= read_bits(pos, len) << (64 - lead - len);
+			}
+			x[i] = from_bits(prev);
+		}
+	}
+
+	/**
+	* Frame-of-reference encoding: offsets to the minimum of the block, on the bit width of its range.
+	*/
+	void encode(const std::vector<ValType>& x, Block& block, std::false_type)
+	{
+		block.base = *std::min_element(x.begin(), x.end());
+		uint64_t range = static_cast<uint64_t>(*std::max_element(x.begin(), x.end())) - static_cast<uint64_t>(block.base);
+		block.width = 64 - leading_zeros(range);
+		for (const auto& e : x)
+			write_bits(static_cast<uint64_t>(e) - static_cast<uint64_t>(block.base), block.width);
+	}
+
+	void decode(const Block& block, std::vector<ValType>& x, std::false_type) const
+	{
+		size_t pos = block.bit_offset;
+		for (auto& e : x)
+			e = static_cast<ValType>(static_cast<uint64_t>(block.base) + read_bits(pos, block.width));
+	}
+
+	static uint64_t to_bits(ValType x)
+	{
+		double d = static_cast<double>(x);
+		uint64_t bits;
+		std::memcpy(&bits, &d, sizeof(bits));
+		return bits;
+	}
+
+	static ValType from_bits(uint64_t bits)
+	{
+		double d;
+		std::memcpy(&d, &bits, sizeof(d));
+		return static_cast<ValType>(d);
+	}
+
+	size_t _block_size;
+	std::vector<uint64_t> _bits;
+	size_t _n_bits;
+	std::vector<Block> _blocks;
+	std::vector<ValType> _tail;
+};
@@ -0,0 +1,294 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <locale>
+#include <clocale>
+#include <algorithm>
+#include <thread>
+#include "CMappedFile.hpp"
+#include "CRunningMoments.hpp"
+
+
+/**
+* Loader of numeric columns from CSV or delimited text files.
+*
+* The file is a `MappedFile`, split into chunks aligned on newlines, parsed in parallel,
+* each thread filling its own column buffers, concatenated in the order of the file at the end.
+* Optionally, running moments of each column are computed while parsing,
+* so that simple statistics need no second pass on values.
+*
+* Fields are parsed as double in the "C" locale, whatever the global locale,
+* empty or non-numeric fields giving NaN, as well as missing fields of short lines.
+* Quoted fields are not supported, except for names of the header.
+*/
+class CsvReader
+{
+public:
+
+	/**
+	* Load a CSV file.
+	*
+	* @param path Path of the input file.
+	* @param delimiter Delimiter of fields.
+	* @param has_header Boolean checking if the first line contains names of columns,
+	* otherwise columns are named by their index.
+	* @param compute_moments Boolean checking if running moments of columns are computed while parsing.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	*/
+	explicit CsvReader(
+		const std::string& path, char delimiter = ',', bool has_header = true,
+		bool compute_moments = true, unsigned int n_threads = 0
+	)
+		: _delimiter(delimiter), _compute_moments(compute_moments)
+	{
+		MappedFile file(path);
+		const char* first = file.data();
+		const char* last = first + file.size();
+
+		const char* line_end = std::find(first, last, '\n');
+		split_names(first, line_end);
+		if (!has_header)
+			for (size_t j = 0; j < _names.size(); ++j)
+				_names[j] = std::to_string(j);
+		else
+			first = line_end == last ? last : line_end + 1;
+
+		const size_t min_chunk = 1 << 20;
+		size_t size = static_cast<size_t>(last - first);
+		if (n_threads == 0)
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		size_t n_chunks = std::max<size_t>(1, std::min<size_t>(n_threads, size / min_chunk));
+
+		std::vector<const char*> bounds(1, first);
+		for (size_t c = 1; c < n_chunks; ++c)
+		{
+			const char* b = std::max(bounds.back(), first + size * c / n_chunks);
+			b = std::find(b, last, '\n');
+			bounds.push_back(b == last ? last : b + 1);
+		}
+		bounds.push_back(last);
+
+		std::vector<Chunk> chunks(n_chunks);
+		std::vector<std::thread> threads;
+		for (size_t c = 0; c < n_chunks; ++c)
+		{
+			if (c + 1 == n_chunks)
+				parse(bounds[c], bounds[c + 1], chunks[c]);
+			else
+				threads.push_back(std::thread([this, &bounds, &chunks, c]() {
+					parse(bounds[c], bounds[c + 1], chunks[c]);
+				}));
+		}
+		for (auto& t : threads)
+			t.join();
+
+		size_t n_cols = _names.size();
+		_rows = 0;
+		for (const auto& chunk : chunks)
+			_rows += chunk.rows;
+		_columns.assign(n_cols, std::vector<double>());
+		_moments.assign(n_cols, RunningMoments());
+		for (size_t j = 0; j < n_cols; ++j)
+		{
+			_columns[j].reserve(_rows);
+			for (const auto& chunk : chunks)
+			{
+				_columns[j].insert(_columns[j].end(), chunk.columns[j].begin(), chunk.columns[j].end());
+				if (_compute_moments)
+					_moments[j].merge(chunk.moments[j]);
+			}
+		}
+	}
+
+	size_t rows() const { return _rows; }
+
+	size_t cols() const { return _names.size(); }
+
+	/**
+	* Names of columns, in the order of the file.
+	*/
+	const std::vector<std::string>& get_names() const { return _names; }
+
+	/**
+	* Values of a column.
+	*
+	* @param j Index of the column.
+	*/
+	const std::vector<double>& column(size_t j) const
+	{
+		if (j >= _columns.size())
+			throw std::invalid_argument("Index of column is out of range.");
+		return _columns[j];
+	}
+
+	/**
+	* Values of a column.
+	*
+	* @param name Name of the column.
+	*/
+	const std::vector<double>& column(const std::string& name) const
+	{
+		return column(index(name));
+	}
+
+	/**
+	* Running moments of the non-NaN values of a column, computed while parsing.
+	*
+	* @param j Index of the column.
+	*/
+	const RunningMoments& get_moments(size_t j) const
+	{
+		if (!_compute_moments)
+			throw std::logic_error("Moments were not computed while parsing.");
+		if (j >= _moments.size())
+			throw std::invalid_argument("Index of column is out of range.");
+		return _moments[j];
+	}
+
+	/**
+	* Running moments of the non-NaN values of a column, computed while parsing.
+	*
+	* @param name Name of the column.
+	*/
+	const RunningMoments& get_moments(const std::string& name) const
+	{
+		return get_moments(index(name));
+	}
+
+	/**
+	* Parse a field, NaN if it is empty or not entirely numeric.
+	* Short fields are copied in a stack buffer, long fields in a string.
+	*/
+	static double parse_field(const char* first, const char* last)
+	{
+		while (first != last && (*first == ' ' || *first == '\t'))
+			++first;
+		while (last != first && (*(last - 1) == ' ' || *(last - 1) == '\t'))
+			--last;
+		size_t size = static_cast<size_t>(last - first);
+		if (size == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		char buffer[64];
+		if (size < sizeof(buffer))
+		{
+			std::memcpy(buffer, first, size);
+			buffer[size] = '\0';
+			return parse_number(buffer, size);
+		}
+		std::string field(first, last);
+		return parse_number(field.c_str(), size);
+	}
+
+	/**
+	* Parse a null-terminated number in the "C" locale: by `strtod` if the decimal point of the global locale is '.',
+	* and by a stream imbued with the classic locale otherwise.
+	*/
+	static double parse_number(const char* str, size_t size)
+	{
+		const char* point = std::localeconv()->decimal_point;
+		double x;
+		bool is_valid;
+		if (point[0] == '.' && point[1] == '\0')
+		{
+			char* end;
+			x = std::strtod(str, &end);
+			is_valid = end == str + size;
+		}
+		else
+		{
+			std::istringstream is(std::string(str, size));
+			is.imbue(std::locale::classic());
+			is >> x;
+			is_valid = !is.fail() && is.peek() == std::char_traits<char>::eof();
+		}
+		return is_valid ? x : std::numeric_limits<double>::quiet_NaN();
+	}
+
+protected:
+
+	struct Chunk
+	{
+		Chunk() : rows(0) {}
+
+		size_t rows;
+		std::vector<std::vector<double>> columns;
+		std::vector<RunningMoments> moments;
+	};
+
+	size_t index(const std::string& name) const
+	{
+		for (size_t j = 0; j < _names.size(); ++j)
+			if (_names[j] == name)
+				return j;
+		throw std::invalid_argument("Column is not in file: " + name);
+	}
+
+	void split_names(const char* first, const char* last)
+	{
+		if (last != first && *(last - 1) == '\r')
+			--last;
+		while (true)
+		{
+			const char* field_end = std::find(first, last, _delimiter);
+			std::string name(first, field_end);
+			size_t b = name.find_first_not_of(" \t\""), e = name.find_last_not_of(" \t\"");
+			_names.push_back(b == std::string::npos ? std::string() : name.substr(b, e - b + 1));
+			if (field_end == last)
+				break;
+			first = field_end + 1;
+		}
+	}
+
+	/**
+	* Parse the lines of a chunk, skipping empty lines.
+	*/
+	void parse(const char* first, const char* last, Chunk& chunk) const
+	{
+		size_t n_cols = _names.size();
+		chunk.columns.assign(n_cols, std::vector<double>());
+		chunk.moments.assign(n_cols, RunningMoments());
+		while (first < last)
+		{
+			const char* line_end = std::find(first, last, '\n');
+			const char* next = line_end == last ? last : line_end + 1;
+			if (line_end != first && *(line_end - 1) == '\r')
+				--line_end;
+			if (line_end == first)
+			{
+				first = next;
+				continue;
+			}
+
+			const char* field = first;
+			for (size_t j = 0; j < n_cols; ++j)
+			{
+				double x = std::numeric_limits<double>::quiet_NaN();
+				if (field <= line_end)
+				{
+					const char* field_end = std::find(field, line_end, _delimiter);
+					x = parse_field(field, field_end);
+					field = field_end + 1;
+				}
+				chunk.columns[j].push_back(x);
+				if (_compute_moments && x == x)
+					chunk.moments[j].push(x);
+			}
+			chunk.rows++;
+			first = next;
+		}
+	}
+
+	char _delimiter;
+	bool _compute_moments;
+	size_t _rows;
+	std::vector<std::string> _names;
+	std::vector<std::vector<double>> _columns;
+	std::vector<RunningMoments> _moments;
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <numeric>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "Stats.hpp"
+
+
+/**
+* Immutable data series, caching derived statistics.
+*
+* Mean, sums of powers of centered values, centered copy, sorted copy and ranks
+* are computed on first request and reused by subsequent calls.
+* Caches are not synchronized: a series must not be queried concurrently from several threads.
+*/
+class DataSeries
+{
+public:
+
+	/**
+	* Create data series, copying values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*/
+	template<typename ContType>
+	DataSeries(const ContType& x)
+		: _data(x.begin(), x.end())
+	{
+		_has_mean = false, _has_moments = false, _has_mad = false;
+		_mean = 0, _sx2 = 0, _sx3 = 0, _sx4 = 0, _mad = 0;
+	}
+
+	size_t size() const { return _data.size(); }
+
+	const std::vector<double>& values() const { return _data; }
+
+	/**
+	* Mean, cached.
+	*/
+	double mean() const
+	{
+		if (!_has_mean)
+		{
+			_mean = Stats::mean(_data);
+			_has_mean = true;
+		}
+		return _mean;
+	}
+
+	/**
+	* Variance, from cached sum of squared centered values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double var(size_t ddof = 0) const
+	{
+		size_t size = _data.size();
+		if (size <= 1)
+			throw std::invalid_argument("Input has not enough values for var.");
+		if (size - ddof == 0)
+			throw std::invalid_argument("Size minus degree of freedom is 0.");
+
+		compute_moments();
+		return _sx2 / (size - ddof);
+	}
+
+	/**
+	* Standard deviation, from cached sum of squared centered values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double std(size_t ddof = 0) const
+	{
+		return std::sqrt(var(ddof));
+	}
+
+	/**
+	* Skewness, from cached sums of powers of centered values.
+	*/
+	double skewness() const
+	{
+		size_t size = _data.size();
+		if (size <= 1)
+			throw std::invalid_argument("Input has not enough values for skewness.");
+
+		compute_moments();
+		return (_sx3 * std::pow(size, 0.5)) / std::pow(_sx2, 1.5);
+	}
+
+	/**
+	* Non-normalized kurtosis, from cached sums of powers of centered values.
+	*/
+	double kurtosis() const
+	{
+		size_t size = _data.size();
+		if (size <= 1)
+			throw std::invalid_argument("Input has not enough values for kurtosis.");
+
+		compute_moments();
+		return (_sx4 * size) / (_sx2 * _sx2);
+	}
+
+	/**
+	* Median, from cached sorted copy.
+	*/
+	double median() const
+	{
+		size_t size = _data.size();
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for median.");
+
+		const std::vector<double>& x_sort = sorted();
+		if (size % 2 == 0)
+			return (x_sort[size / 2 - 1] + x_sort[size / 2]) / 2;
+		return x_sort[size / 2];
+	}
+
+	/**
+	* Median absolute deviation, cached.
+	*
+	* @param is_rescaled Boolean to rescale output, in order to be an estimator consistent
+	* for the estimation of the standard deviation of normally distributed values.
+	*/
+	double median_abs_deviation(bool is_rescaled = false) const
+	{
+		if (!_has_mad)
+		{
+			double med = median();
+			std::vector<double> x_cent_abs(_data.size());
+			std::transform(_data.begin(), _data.end(), x_cent_abs.begin(), [med](double e) { return std::fabs(e - med); });
+			_mad = Stats::select_quantiles(x_cent_abs, { 0.5 })[0];
+			_has_mad = true;
+		}
+		return is_rescaled ? _mad * 1.4826 : _mad;
+	}
+
+	/**
+	* Centered values, cached.
+	*/
+	const std::vector<double>& center() const
+	{
+		if (_centered.size() != _data.size())
+		{
+			double m = mean();
+			_centered.resize(_data.size());
+			std::transform(_data.begin(), _data.end(), _centered.begin(), [m](double e) { return e - m; });
+		}
+		return _centered;
+	}
+
+	/**
+	* Standard scores, from cached centered values and standard deviation.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	std::vector<double> zscore(size_t ddof = 0) const
+	{
+		size_t size = _data.size();
+		if (size <= 1)
+			throw std::invalid_argument("Input has not enough values for zscore.");
+
+		double s = std(ddof);
+		const std::vector<double>& x_cent = center();
+		std::vector<double> z(size);
+		std::transform(x_cent.begin(), x_cent.end(), z.begin(), [s](double e) { return e / s; });
+		return z;
+	}
+
+	/**
+	* Sorted values, cached.
+	*/
+	const std::vector<double>& sorted() const
+	{
+		if (_sorted.size() != _data.size())
+		{
+			_sorted = _data;
+			std::sort(_sorted.begin(), _sorted.end());
+		}
+		return _sorted;
+	}
+
+	/**
+	* Ranks, as computed by `Stats::rankdata`, cached.
+	*/
+	const std::vector<unsigned int>& rankdata() const
+	{
+		if (_ranks.size() != _data.size())
+			_ranks = Stats::rankdata(_data);
+		return _ranks;
+	}
+
+	/**
+	* Pearson product-moment correlation coefficient, from cached centered values.
+	*
+	* @param x, y Input data series.
+	*
+	* @return Pearson product-moment correlation coefficient of `x` and `y`.
+	*/
+	static double pearsonr(const DataSeries& x, const DataSeries& y)
+	{
+		size_t size = x.size();
+		if (size != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Inputs have not enough values for pearsonr.");
+
+		x.compute_moments();
+		y.compute_moments();
+		if (x._sx2 <= 0 || y._sx2 <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		const std::vector<double>& x_cent = x.center();
+		const std::vector<double>& y_cent = y.center();
+		double sxy = std::inner_product(x_cent.begin(), x_cent.end(), y_cent.begin(), 0.0);
+		double r = sxy / (std::sqrt(x._sx2) * std::sqrt(y._sx2));
+		return std::max(std::min(r, 1.0), -1.0);
+	}
+
+	/**
+	* Spearman rank-order correlation coefficient, from cached ranks.
+	*
+	* @param x, y Input data series.
+	*
+	* @return Spearman rank-order correlation coefficient of `x` and `y`.
+	*/
+	static double spearmanr(const DataSeries& x, const DataSeries& y)
+	{
+		if (x.size() != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (x.size() == 0)
+			throw std::invalid_argument("Inputs have not enough values for spearmanr.");
+
+		return pearsonr(DataSeries(x.rankdata()), DataSeries(y.rankdata()));
+	}
+
+protected:
+
+	void compute_moments() const
+	{
+		if (_has_moments)
+			return;
+
+		const std::vector<double>& x_cent = center();
+		_sx2 = 0, _sx3 = 0, _sx4 = 0;
+		for (double e : x_cent)
+		{
+			double e2 = e * e;
+			_sx2 += e2;
+			_sx3 += e2 * e;
+			_sx4 += e2 * e2;
+		}
+		_has_moments = true;
+	}
+
+	const std::vector<double> _data;
+
+	mutable bool _has_mean, _has_moments, _has_mad;
+	mutable double _mean, _sx2, _sx3, _sx4, _mad;
+	mutable std::vector<double> _centered, _sorted;
+	mutable std::vector<unsigned int> _ranks;
+};
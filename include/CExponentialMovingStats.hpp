@@ -0,0 +1,148 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+
+
+/**
+* Exponentially weighted moving statistics, updated in O(1) per value.
+*
+* Weights of past values decay by a factor `1 - alpha` at each new value,
+* with `alpha = 1 - exp(-ln(2) / halflife)`, and are normalized by their sum
+* (adjusted weights).
+*
+* @see [pandas.DataFrame.ewm](https://pandas.pydata.org/docs/reference/api/pandas.DataFrame.ewm.html)
+*/
+class ExponentialMovingStats
+{
+public:
+
+	/**
+	* Create exponentially weighted accumulator.
+	*
+	* @param halflife Number of values after which the weight of a value is halved.
+	*/
+	ExponentialMovingStats(double halflife)
+	{
+		if (!(halflife > 0))
+			throw std::invalid_argument("Parameter halflife must be positive.");
+
+		_decay = std::exp(-std::log(2.0) / halflife);
+		reset();
+	}
+
+	/**
+	* Remove all values.
+	*/
+	void reset()
+	{
+		_count = 0;
+		_sw = 0, _sw2 = 0;
+		_mx = 0, _my = 0, _cxx = 0, _cyy = 0, _cxy = 0;
+	}
+
+	double get_alpha() const { return 1.0 - _decay; }
+
+	size_t size() const { return _count; }
+
+	/**
+	* Push a value.
+	*
+	* @param x Input value.
+	*/
+	void push(double x)
+	{
+		push(x, x);
+	}
+
+	/**
+	* Push a pair of values, for covariance and correlation.
+	*
+	* @param x, y Input values.
+	*/
+	void push(double x, double y)
+	{
+		_count++;
+		_sw = _decay * _sw + 1.0;
+		_sw2 = _decay * _decay * _sw2 + 1.0;
+
+		double dx = x - _mx, dy = y - _my;
+		_mx += dx / _sw;
+		_my += dy / _sw;
+		_cxx = _decay * _cxx + dx * (x - _mx);
+		_cyy = _decay * _cyy + dy * (y - _my);
+		_cxy = _decay * _cxy + dx * (y - _my);
+	}
+
+	/**
+	* Exponentially weighted mean of first values.
+	*/
+	double get_mean() const
+	{
+		if (_count == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _mx;
+	}
+
+	/**
+	* Exponentially weighted variance of first values.
+	*
+	* @param ddof Degree of freedom, applied on the effective number of values
+	* `sum(w)^2 / sum(w^2)`.
+	*/
+	double get_var(size_t ddof = 0) const
+	{
+		return comoment(_cxx, ddof);
+	}
+
+	/**
+	* Exponentially weighted standard deviation of first values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_std(size_t ddof = 0) const
+	{
+		return std::sqrt(get_var(ddof));
+	}
+
+	/**
+	* Exponentially weighted covariance of pairs of values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_cov(size_t ddof = 0) const
+	{
+		return comoment(_cxy, ddof);
+	}
+
+	/**
+	* Exponentially weighted Pearson correlation coefficient of pairs of values.
+	*/
+	double get_corr() const
+	{
+		if (_count == 0 || _cxx <= 0 || _cyy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double r = _cxy / (std::sqrt(_cxx) * std::sqrt(_cyy));
+		return r > 1.0 ? 1.0 : (r < -1.0 ? -1.0 : r);
+	}
+
+protected:
+
+	double comoment(double c, size_t ddof) const
+	{
+		if (_count == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double denom = _sw - ddof * _sw2 / _sw;
+		if (denom <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return c / denom;
+	}
+
+	double _decay;
+	size_t _count;
+	double _sw, _sw2;
+	double _mx, _my, _cxx, _cyy, _cxy;
+};
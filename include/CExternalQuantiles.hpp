@@ -0,0 +1,407 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cstdint>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "CChunkedReader.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STATS_EXTERNAL_QUANTILES_STAT 1
+#include <sys/stat.h>
+#endif
+
+
+/**
+* Exact quantiles of data larger than memory, by successive passes of histogram refinement.
+*
+* Values are mapped to 64-bit keys preserving their order, and each pass refines 16 bits of keys:
+* the first pass counts values by the 16 highest bits of their keys, finding the bucket of each target rank,
+* and the next pass collects the values of these buckets, selected in memory,
+* unless a bucket has more values than the memory budget, refined by the 16 next bits instead.
+* Two passes are enough, unless values are very concentrated.
+* Quantiles are linearly interpolated as `Stats::quantiles`, and the median is computed as `Stats::median`.
+* NaN values are ignored.
+*
+* The data set is consumed as many times as needed by the caller:
+* for each pass, values are pushed by `push` or `push_all`, then the pass is closed by `end_pass`, until `is_done`.
+* Every pass must push the same values: `end_pass` throws `std::runtime_error` if the counts of a pass
+* do not match the ones of the previous passes.
+*/
+class ExternalQuantiles
+{
+public:
+
+	/**
+	* Create selector of quantiles.
+	*
+	* @param qs Quantiles, in [0, 1].
+	* @param max_values Maximal number of values collected in memory during a pass.
+	*/
+	explicit ExternalQuantiles(const std::vector<double>& qs, size_t max_values = 1 << 24)
+		: _qs(qs), _max_values(max_values), _count(0), _n_passes(0)
+	{
+		if (std::any_of(qs.begin(), qs.end(), [](double q) { return !(q >= 0 && q <= 1); }))
+			throw std::invalid_argument("Quantiles must be in [0, 1].");
+		if (max_values == 0)
+			throw std::invalid_argument("Parameter max_values must be positive.");
+
+		Bucket root;
+		root.prefix = 0, root.shift = 64, root.is_collected = false;
+		root.counts.assign(n_sub_buckets, 0);
+		_buckets.push_back(root);
+	}
+
+	/**
+	* Boolean checking if all quantiles are known, and no more pass is needed.
+	*/
+	bool is_done() const { return _n_passes > 0 && _buckets.empty(); }
+
+	size_t get_pass_count() const { return _n_passes; }
+
+	/**
+	* Number of non-NaN values, known after the first pass.
+	*/
+	size_t size() const { return _count; }
+
+	/**
+	* Push the values of a chunk, during a pass.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*/
+	template<typename ContType>
+	void push_all(const ContType& x)
+	{
+		for (const auto& e : x)
+			push(static_cast<double>(e));
+	}
+
+	/**
+	* Push a value, during a pass.
+	*
+	* @param x Input value.
+	*/
+	void push(double x)
+	{
+		if (x != x)
+			return;
+		if (_n_passes == 0)
+			_count++;
+		uint64_t key = to_key(x);
+		for (auto& b : _buckets)
+		{
+			if (b.shift < 64 && (key >> b.shift) != b.prefix)
+				continue;
+			if (b.is_collected)
+				b.values.push_back(x);
+			else
+				b.counts[(key >> (b.shift - sub_bits)) & (n_sub_buckets - 1)]++;
+		}
+	}
+
+	/**
+	* Close a pass, finding the buckets of target ranks, or selecting them.
+	*/
+	void end_pass()
+	{
+		if (is_done())
+			throw std::logic_error("All quantiles are already known.");
+		if (_n_passes == 0)
+			init_targets();
+		_n_passes++;
+
+		for (auto& b : _buckets)
+		{
+			bool is_checked = false;
+			for (auto& t : _targets)
+			{
+				if (t.is_resolved || t.prefix != b.prefix || t.shift != b.shift)
+					continue;
+				if (!is_checked)
+				{
+					check_bucket(b, t.count);
+					is_checked = true;
+				}
+				if (b.is_collected)
+				{
+					std::nth_element(b.values.begin(), b.values.begin() + t.offset, b.values.end());
+					t.value = b.values[t.offset];
+					t.is_resolved = true;
+					continue;
+				}
+				size_t j = 0;
+				while (t.offset >= b.counts[j])
+					t.offset -= b.counts[j++];
+				t.count = b.counts[j];
+				t.shift = b.shift - sub_bits;
+				t.prefix = (b.shift == 64 ? 0 : b.prefix << sub_bits) | j;
+				if (t.shift == 0)
+				{
+					t.value = from_key(t.prefix);
+					t.is_resolved = true;
+				}
+			}
+		}
+		plan_pass();
+	}
+
+	/**
+	* Quantiles, linearly interpolated as `Stats::quantiles`, when `is_done`.
+	*
+	* @return Quantiles, in the order of the constructor.
+	*/
+	std::vector<double> get_quantiles() const
+	{
+		check_done();
+		std::vector<double> x_q;
+		for (double q : _qs)
+		{
+			double h = (_count - 1) * q;
+			size_t lo = static_cast<size_t>(h);
+			double frac = h - lo;
+			double x_lo = kth(lo);
+			x_q.push_back(frac == 0 ? x_lo : x_lo + frac * (kth(lo + 1) - x_lo));
+		}
+		return x_q;
+	}
+
+	/**
+	* Median, as computed by `Stats::median`, when `is_done` and 0.5 is one of the quantiles.
+	*/
+	double get_median() const
+	{
+		check_done();
+		if (std::find(_qs.begin(), _qs.end(), 0.5) == _qs.end())
+			throw std::logic_error("Median is not one of the quantiles.");
+		if (_count % 2 == 0)
+			return (kth(_count / 2 - 1) + kth(_count / 2)) / 2;
+		return kth(_count / 2);
+	}
+
+protected:
+
+	static const unsigned int sub_bits = 16;
+	static const size_t n_sub_buckets = size_t(1) << sub_bits;
+
+	/**
+	* Bucket of keys whose `64 - shift` highest bits are `prefix`, whose values are collected, or counted by sub-buckets.
+	*/
+	struct Bucket
+	{
+		uint64_t prefix;
+		unsigned int shift;
+		bool is_collected;
+		std::vector<size_t> counts;
+		std::vector<double> values;
+	};
+
+	/**
+	* Order statistic, in a bucket of `count` values, at rank `offset` in the bucket.
+	*/
+	struct Target
+	{
+		size_t rank;
+		uint64_t prefix;
+		unsigned int shift;
+		size_t offset, count;
+		bool is_resolved;
+		double value;
+	};
+
+	/**
+	* Order-preserving map of doubles to unsigned integers.
+	*/
+	static uint64_t to_key(double x)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+	}
+
+	static double from_key(uint64_t key)
+	{
+		uint64_t bits = (key >> 63) ? key & ~(uint64_t(1) << 63) : ~key;
+		double x;
+		std::memcpy(&x, &bits, sizeof(x));
+		return x;
+	}
+
+	void check_done() const
+	{
+		if (!is_done())
+			throw std::logic_error("Quantiles are not known before the last pass.");
+		if (_count == 0)
+			throw std::invalid_argument("Input has not enough values for quantiles.");
+	}
+
+	/**
+	* Check that a bucket got as many values during the pass as counted by the previous pass.
+	*/
+	static void check_bucket(const Bucket& b, size_t count)
+	{
+		size_t n = b.values.size();
+		if (!b.is_collected)
+		{
+			n = 0;
+			for (size_t c : b.counts)
+				n += c;
+		}
+		if (n != count)
+			throw std::runtime_error("Input changed between passes.");
+	}
+
+	double kth(size_t rank) const
+	{
+		for (const auto& t : _targets)
+			if (t.rank == rank)
+				return t.value;
+		throw std::logic_error("Rank is not a target.");
+	}
+
+	/**
+	* Target ranks of quantiles, as selected by `Stats::select_quantiles`.
+	*/
+	void init_targets()
+	{
+		if (_count == 0)
+			return;
+		std::vector<size_t> ranks;
+		for (double q : _qs)
+		{
+			double h = (_count - 1) * q;
+			size_t lo = static_cast<size_t>(h);
+			ranks.push_back(lo);
+			if (h != lo)
+				ranks.push_back(lo + 1);
+		}
+		std::sort(ranks.begin(), ranks.end());
+		ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+		for (size_t r : ranks)
+		{
+			Target t = { r, 0, 64, r, _count, false, 0.0 };
+			_targets.push_back(t);
+		}
+	}
+
+	/**
+	* Buckets of the next pass: buckets of unresolved targets are collected within the memory budget,
+	* smallest first, and refined otherwise.
+	*/
+	void plan_pass()
+	{
+		std::vector<Bucket> buckets;
+		std::vector<const Target*> pending;
+		for (const auto& t : _targets)
+		{
+			if (t.is_resolved)
+				continue;
+			bool is_new = true;
+			for (const auto* p : pending)
+				is_new = is_new && !(p->prefix == t.prefix && p->shift == t.shift);
+			if (is_new)
+				pending.push_back(&t);
+		}
+		std::sort(pending.begin(), pending.end(), [](const Target* a, const Target* b) { return a->count < b->count; });
+
+		size_t n_values = 0;
+		for (const auto* p : pending)
+		{
+			Bucket b;
+			b.prefix = p->prefix, b.shift = p->shift;
+			b.is_collected = n_values + p->count <= _max_values;
+			if (b.is_collected)
+			{
+				n_values += p->count;
+				b.values.reserve(p->count);
+			}
+			else
+				b.counts.assign(n_sub_buckets, 0);
+			buckets.push_back(b);
+		}
+		_buckets.swap(buckets);
+	}
+
+	std::vector<double> _qs;
+	size_t _max_values;
+	size_t _count, _n_passes;
+	std::vector<Bucket> _buckets;
+	std::vector<Target> _targets;
+};
+
+
+/**
+* Check that a file can be read several times, so not the standard input nor, on POSIX systems, a pipe or a socket.
+*
+* @param path Path of the input file.
+*/
+inline void check_rereadable(const std::string& path)
+{
+	if (path == "-")
+		throw std::invalid_argument("Standard input can not be read several times.");
+#ifdef STATS_EXTERNAL_QUANTILES_STAT
+	struct stat st;
+	if (::stat(path.c_str(), &st) != 0)
+		throw std::runtime_error("File can not be opened: " + path);
+	if (!S_ISREG(st.st_mode) && !S_ISBLK(st.st_mode))
+		throw std::invalid_argument("File can not be read several times: " + path);
+#endif
+}
+
+/**
+* Exact quantiles of a file larger than memory, read by `ChunkedReader` as many times as needed, usually twice.
+* The file must be a regular file, not modified between passes.
+*
+* @tparam ValType The numeric data type of the values of the file.
+*
+* @param path Path of the input file.
+* @param qs Quantiles, in [0, 1].
+* @param format Format of the values of the file.
+* @param max_values Maximal number of values collected in memory during a pass.
+*
+* @return Quantiles, linearly interpolated as `Stats::quantiles`, in the order of `qs`.
+*/
+template<typename ValType = double>
+std::vector<double> external_quantiles(
+	const std::string& path, const std::vector<double>& qs,
+	StreamFormat format = STREAM_BINARY, size_t max_values = 1 << 24
+)
+{
+	check_rereadable(path);
+	ExternalQuantiles selector(qs, max_values);
+	while (!selector.is_done())
+	{
+		ChunkedReader<ValType> reader(path, format);
+		reader.for_each([&selector](const ArrayView<ValType>& chunk) { selector.push_all(chunk); });
+		selector.end_pass();
+	}
+	return selector.get_quantiles();
+}
+
+/**
+* Exact median of a file larger than memory, as computed by `Stats::median`.
+* The file must be a regular file, not modified between passes.
+*
+* @tparam ValType The numeric data type of the values of the file.
+*
+* @param path Path of the input file.
+* @param format Format of the values of the file.
+* @param max_values Maximal number of values collected in memory during a pass.
+*/
+template<typename ValType = double>
+double external_median(const std::string& path, StreamFormat format = STREAM_BINARY, size_t max_values = 1 << 24)
+{
+	check_rereadable(path);
+	ExternalQuantiles selector({ 0.5 }, max_values);
+	while (!selector.is_done())
+	{
+		ChunkedReader<ValType> reader(path, format);
+		reader.for_each([&selector](const ArrayView<ValType>& chunk) { selector.push_all(chunk); });
+		selector.end_pass();
+	}
+	return selector.get_median();
+}
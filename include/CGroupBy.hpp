@@ -0,0 +1,336 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <cstdint>
+#include <thread>
+
+
+/**
+* Group-by aggregation of values by unsorted keys.
+*
+* Keys are hashed into an open-addressing table with linear probing,
+* whose slots hold mergeable moments (count, sum, minimum, maximum, sum of squared deviations),
+* updated in one pass. Parallel aggregation uses one table per thread, merged at the end.
+*
+* @tparam KeyType The type of keys.
+* @tparam Hash The type of the hash function of keys.
+*/
+template<typename KeyType, typename Hash = std::hash<KeyType>>
+class GroupBy
+{
+public:
+
+	/**
+	* Mergeable moments of a group.
+	*/
+	struct Moments
+	{
+		size_t count;
+		double mean, m2, min, max;
+
+		void push(double x)
+		{
+			count++;
+			double dx = x - mean;
+			mean += dx / count;
+			m2 += dx * (x - mean);
+			min = std::min(min, x);
+			max = std::max(max, x);
+		}
+
+		void merge(const Moments& other)
+		{
+			if (other.count == 0)
+				return;
+			double n = static_cast<double>(count + other.count);
+			double delta = other.mean - mean;
+			m2 += other.m2 + delta * delta * count * other.count / n;
+			mean += delta * other.count / n;
+			count += other.count;
+			min = std::min(min, other.min);
+			max = std::max(max, other.max);
+		}
+	};
+
+	/**
+	* Create empty aggregator.
+	*
+	* @param capacity Initial number of slots, rounded up to a power of two.
+	*/
+	GroupBy(size_t capacity = 16)
+	{
+		size_t c = 16;
+		while (c < capacity)
+			c *= 2;
+		_used.assign(c, false);
+		_keys.resize(c);
+		_moments.resize(c);
+		_size = 0;
+	}
+
+	/**
+	* Number of groups.
+	*/
+	size_t size() const { return _size; }
+
+	/**
+	* Push a value in the group of a key.
+	*
+	* @param key Key of the group.
+	* @param x Input value.
+	*/
+	void push(const KeyType& key, double x)
+	{
+		_moments[slot(key)].push(x);
+	}
+
+	/**
+	* Aggregate values by keys, in one pass, using one table per thread merged at the end.
+	*
+	* @tparam KContType The type of the sequence container of keys.
+	* @tparam ContType The type of the sequence container of values.
+	*
+	* @param keys Input sequence container containing keys, in any order.
+	* @param x Input sequence container containing values.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	*/
+	template<typename KContType, typename ContType>
+	void fit(const KContType& keys, const ContType& x, unsigned int n_threads = 0)
+	{
+		size_t size = x.size();
+		if (size != keys.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+
+		const size_t min_chunk = 1 << 16;
+		if (n_threads == 0)
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		size_t n_chunks = std::max<size_t>(1, std::min<size_t>(n_threads, size / min_chunk));
+
+		auto run_chunk = [](GroupBy& table, typename KContType::const_iterator k_it,
+			typename ContType::const_iterator x_it, size_t n) {
+			for (size_t i = 0; i < n; ++i, ++k_it, ++x_it)
+				table.push(*k_it, static_cast<double>(*x_it));
+		};
+
+		std::vector<GroupBy> tables(n_chunks - 1);
+		std::vector<std::thread> threads;
+		auto k_it = keys.begin();
+		auto x_it = x.begin();
+		for (size_t c = 0; c < n_chunks; ++c)
+		{
+			size_t n = size * (c + 1) / n_chunks - size * c / n_chunks;
+			if (c + 1 == n_chunks)
+				run_chunk(*this, k_it, x_it, n);
+			else
+			{
+				threads.push_back(std::thread(run_chunk, std::ref(tables[c]), k_it, x_it, n));
+				std::advance(k_it, n), std::advance(x_it, n);
+			}
+		}
+		for (auto& t : threads)
+			t.join();
+		for (const auto& table : tables)
+			merge(table);
+	}
+
+	/**
+	* Merge the groups of another aggregator.
+	*
+	* @param other Aggregator to merge.
+	*/
+	void merge(const GroupBy& other)
+	{
+		for (size_t i = 0; i < other._used.size(); ++i)
+			if (other._used[i])
+				_moments[slot(other._keys[i])].merge(other._moments[i]);
+	}
+
+	/**
+	* Keys of groups, in the order of the table.
+	*/
+	std::vector<KeyType> get_keys() const
+	{
+		std::vector<KeyType> keys;
+		keys.reserve(_size);
+		for (size_t i = 0; i < _used.size(); ++i)
+			if (_used[i])
+				keys.push_back(_keys[i]);
+		return keys;
+	}
+
+	/**
+	* Moments of the group of a key.
+	*
+	* @param key Key of the group.
+	*/
+	const Moments& get_moments(const KeyType& key) const
+	{
+		size_t i = find(key);
+		if (i == npos())
+			throw std::invalid_argument("Key is not in groups.");
+		return _moments[i];
+	}
+
+	size_t count(const KeyType& key) const { return get_moments(key).count; }
+
+	double sum(const KeyType& key) const { return get_moments(key).mean * get_moments(key).count; }
+
+	double min(const KeyType& key) const { return get_moments(key).min; }
+
+	double max(const KeyType& key) const { return get_moments(key).max; }
+
+	double mean(const KeyType& key) const { return get_moments(key).mean; }
+
+	/**
+	* Variance of the group of a key, as computed by `Stats::var`.
+	*
+	* @param key Key of the group.
+	* @param ddof Degree of freedom.
+	*
+	* @return Variance of the group, NaN if it has not more than `ddof` values or not more than one value
+	* (even with `ddof` 0, as `Stats::var` throws for such groups).
+	*/
+	double var(const KeyType& key, size_t ddof = 0) const
+	{
+		return var(get_moments(key), ddof);
+	}
+
+	/**
+	* Standard deviation of the group of a key, as computed by `Stats::std`.
+	*
+	* @param key Key of the group.
+	* @param ddof Degree of freedom.
+	*/
+	double std(const KeyType& key, size_t ddof = 0) const
+	{
+		return std::sqrt(var(key, ddof));
+	}
+
+	/**
+	* Means of groups, in the order of `get_keys`.
+	*/
+	std::vector<double> get_means() const
+	{
+		std::vector<double> means;
+		for (size_t i = 0; i < _used.size(); ++i)
+			if (_used[i])
+				means.push_back(_moments[i].mean);
+		return means;
+	}
+
+	/**
+	* Variances of groups, in the order of `get_keys`, NaN for groups with not more than `ddof` values
+	* or not more than one value.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	std::vector<double> get_vars(size_t ddof = 0) const
+	{
+		std::vector<double> vars;
+		for (size_t i = 0; i < _used.size(); ++i)
+			if (_used[i])
+				vars.push_back(var(_moments[i], ddof));
+		return vars;
+	}
+
+	/**
+	* Standard deviations of groups, in the order of `get_keys`.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	std::vector<double> get_stds(size_t ddof = 0) const
+	{
+		std::vector<double> stds = get_vars(ddof);
+		for (auto& e : stds)
+			e = std::sqrt(e);
+		return stds;
+	}
+
+protected:
+
+	static size_t npos() { return std::numeric_limits<size_t>::max(); }
+
+	static double var(const Moments& m, size_t ddof)
+	{
+		if (m.count <= ddof || m.count <= 1)
+			return std::numeric_limits<double>::quiet_NaN();
+		return m.m2 / (m.count - ddof);
+	}
+
+	/**
+	* First slot probed for a key, mixing bits of its hash so that identity hashes spread over slots.
+	*/
+	static size_t bucket(const KeyType& key, size_t mask)
+	{
+		uint64_t h = static_cast<uint64_t>(Hash()(key));
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		return static_cast<size_t>(h) & mask;
+	}
+
+	size_t find(const KeyType& key) const
+	{
+		size_t mask = _used.size() - 1;
+		for (size_t i = bucket(key, mask); _used[i]; i = (i + 1) & mask)
+			if (_keys[i] == key)
+				return i;
+		return npos();
+	}
+
+	/**
+	* Slot of a key, inserting it with empty moments if needed.
+	*/
+	size_t slot(const KeyType& key)
+	{
+		size_t mask = _used.size() - 1;
+		size_t i = bucket(key, mask);
+		for (; _used[i]; i = (i + 1) & mask)
+			if (_keys[i] == key)
+				return i;
+
+		if (2 * (_size + 1) > _used.size())
+		{
+			grow();
+			return slot(key);
+		}
+		_used[i] = true;
+		_keys[i] = key;
+		Moments m = { 0, 0.0, 0.0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity() };
+		_moments[i] = m;
+		_size++;
+		return i;
+	}
+
+	void grow()
+	{
+		std::vector<bool> used(2 * _used.size(), false);
+		std::vector<KeyType> keys(2 * _used.size());
+		std::vector<Moments> moments(2 * _used.size());
+		used.swap(_used), keys.swap(_keys), moments.swap(_moments);
+
+		size_t mask = _used.size() - 1;
+		for (size_t i = 0; i < used.size(); ++i)
+		{
+			if (!used[i])
+				continue;
+			size_t j = bucket(keys[i], mask);
+			while (_used[j])
+				j = (j + 1) & mask;
+			_used[j] = true;
+			_keys[j] = keys[i];
+			_moments[j] = moments[i];
+		}
+	}
+
+	std::vector<bool> _used;
+	std::vector<KeyType> _keys;
+	std::vector<Moments> _moments;
+	size_t _size;
+};
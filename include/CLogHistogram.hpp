@@ -0,0 +1,303 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include "Stats.hpp"
+
+
+/**
+* Log-bucketed histogram with fixed relative error, for latency distributions.
+*
+* Bucket boundaries grow geometrically by a factor `gamma = (1 + alpha) / (1 - alpha)`,
+* so that any quantile is estimated with a relative error lower than `alpha`.
+* Recording is O(1) and lock-free, using relaxed atomic counters:
+* values can be recorded concurrently from many threads,
+* while queries running concurrently with recordings see an approximate snapshot.
+*
+* @see [DDSketch](https://arxiv.org/abs/1908.10693)
+* @see [HdrHistogram](http://hdrhistogram.org/)
+*/
+class LogHistogram
+{
+public:
+
+	/**
+	* Create log-bucketed histogram.
+	*
+	* @param relative_accuracy Relative accuracy `alpha` of quantiles, in (0, 1).
+	* @param min_value Minimal value recorded with relative accuracy,
+	* lower values being counted in a zero bucket.
+	* @param max_value Maximal value recorded with relative accuracy,
+	* greater values being counted in the last bucket.
+	*/
+	LogHistogram(double relative_accuracy = 0.01, double min_value = 1e-9, double max_value = 1e9)
+	{
+		if (!(relative_accuracy > 0 && relative_accuracy < 1))
+			throw std::invalid_argument("Parameter relative_accuracy must be in (0, 1).");
+		if (!(min_value > 0 && max_value > min_value))
+			throw std::invalid_argument("Parameters min_value and max_value must be positive and increasing.");
+
+		_relative_accuracy = relative_accuracy;
+		_min_value = min_value, _max_value = max_value;
+		_gamma = (1 + relative_accuracy) / (1 - relative_accuracy);
+		_inv_log_gamma = 1.0 / std::log(_gamma);
+
+		size_t n_keys = static_cast<size_t>(std::ceil(std::log(max_value / min_value) * _inv_log_gamma)) + 1;
+		_counts = std::vector<std::atomic<uint64_t>>(n_keys + 1);
+		reset();
+	}
+
+	/**
+	* Remove all values. Not thread-safe wrt. concurrent recordings.
+	*/
+	void reset()
+	{
+		for (auto& c : _counts)
+			c.store(0, std::memory_order_relaxed);
+		_count.store(0, std::memory_order_relaxed);
+		_sum.store(0, std::memory_order_relaxed);
+		_sum2.store(0, std::memory_order_relaxed);
+		_shift.store(std::numeric_limits<double>::quiet_NaN(), std::memory_order_relaxed);
+		_min.store(std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+		_max.store(-std::numeric_limits<double>::infinity(), std::memory_order_relaxed);
+	}
+
+	double get_relative_accuracy() const { return _relative_accuracy; }
+
+	size_t get_bucket_count() const { return _counts.size(); }
+
+	uint64_t size() const { return _count.load(std::memory_order_relaxed); }
+
+	/**
+	* Record a value, in O(1) and lock-free.
+	*
+	* @param x Input value.
+	* @param count Number of occurrences of `x`.
+	*/
+	void record(double x, uint64_t count = 1)
+	{
+		_counts[bucket(x)].fetch_add(count, std::memory_order_relaxed);
+		_count.fetch_add(count, std::memory_order_relaxed);
+		double d = x - get_shift(x);
+		atomic_add(_sum, d * count);
+		atomic_add(_sum2, d * d * count);
+
+		double m = _min.load(std::memory_order_relaxed);
+		while (x < m && !_min.compare_exchange_weak(m, x, std::memory_order_relaxed)) {}
+		m = _max.load(std::memory_order_relaxed);
+		while (x > m && !_max.compare_exchange_weak(m, x, std::memory_order_relaxed)) {}
+	}
+
+	/**
+	* Record all values of a container.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*/
+	template<typename ContType>
+	void record_all(const ContType& x)
+	{
+		for (const auto& e : x)
+			record(static_cast<double>(e));
+	}
+
+	/**
+	* Merge the values of another histogram, with the same parameters.
+	*
+	* @param other Histogram to merge.
+	*/
+	void merge(const LogHistogram& other)
+	{
+		if (other._counts.size() != _counts.size() || other._gamma != _gamma || other._min_value != _min_value)
+			throw std::invalid_argument("Histograms have not the same parameters.");
+
+		for (size_t i = 0; i < _counts.size(); ++i)
+			_counts[i].fetch_add(other._counts[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		uint64_t n = other._count.load(std::memory_order_relaxed);
+		double other_shift = other._shift.load(std::memory_order_relaxed);
+		if (n > 0)
+		{
+			// sums of deviations from the shift of the other histogram, moved to the shift of this one
+			double d = other_shift - get_shift(other_shift);
+			double s = other._sum.load(std::memory_order_relaxed);
+			_count.fetch_add(n, std::memory_order_relaxed);
+			atomic_add(_sum, s + n * d);
+			atomic_add(_sum2, other._sum2.load(std::memory_order_relaxed) + 2 * d * s + n * d * d);
+		}
+
+		double x = other._min.load(std::memory_order_relaxed);
+		double m = _min.load(std::memory_order_relaxed);
+		while (x < m && !_min.compare_exchange_weak(m, x, std::memory_order_relaxed)) {}
+		x = other._max.load(std::memory_order_relaxed);
+		m = _max.load(std::memory_order_relaxed);
+		while (x > m && !_max.compare_exchange_weak(m, x, std::memory_order_relaxed)) {}
+	}
+
+	double get_min() const { return size() > 0 ? _min.load(std::memory_order_relaxed) : std::numeric_limits<double>::quiet_NaN(); }
+
+	double get_max() const { return size() > 0 ? _max.load(std::memory_order_relaxed) : std::numeric_limits<double>::quiet_NaN(); }
+
+	/**
+	* Exact mean of recorded values.
+	*/
+	double get_mean() const
+	{
+		uint64_t n = size();
+		if (n == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _shift.load(std::memory_order_relaxed) + _sum.load(std::memory_order_relaxed) / n;
+	}
+
+	/**
+	* Variance of recorded values, from their shifted sums: sums of deviations from the first recorded value,
+	* and of their squares, which do not cancel when the mean is large wrt. the spread of values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_var(size_t ddof = 0) const
+	{
+		uint64_t n = size();
+		if (n <= ddof)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double s = _sum.load(std::memory_order_relaxed);
+		double m2 = _sum2.load(std::memory_order_relaxed) - s * s / n;
+		return std::max(m2, 0.0) / (n - ddof);
+	}
+
+	/**
+	* Standard deviation of recorded values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_std(size_t ddof = 0) const
+	{
+		return std::sqrt(get_var(ddof));
+	}
+
+	/**
+	* Estimated quantile, with a relative error lower than the relative accuracy,
+	* for values in [min_value, max_value].
+	*
+	* @param q Quantile, in [0, 1].
+	*/
+	double quantile(double q) const
+	{
+		if (!(q >= 0 && q <= 1))
+			throw std::invalid_argument("Quantile must be in [0, 1].");
+		uint64_t n = size();
+		if (n == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double rank = q * (n - 1);
+		uint64_t cum = 0;
+		size_t i = 0;
+		for (; i + 1 < _counts.size(); ++i)
+		{
+			cum += _counts[i].load(std::memory_order_relaxed);
+			if (cum > rank)
+				break;
+		}
+		return std::min(std::max(bucket_value(i), get_min()), get_max());
+	}
+
+	/**
+	* Estimated median.
+	*/
+	double median() const
+	{
+		return quantile(0.5);
+	}
+
+	/**
+	* Summary statistics, as returned by `Stats::describe`:
+	* moments other than mean, variance and standard deviation,
+	* harmonic and geometric means and median absolute deviation are not available, and are NaN.
+	*
+	* @param ddof Degree of freedom, for variance and standard deviation.
+	*/
+	Stats::Description describe(size_t ddof = 0) const
+	{
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		Stats::Description desc = {
+			static_cast<size_t>(size()), get_min(), get_max(),
+			get_mean(), get_var(ddof), get_std(ddof), nan, nan,
+			nan, nan,
+			median(), quantile(0.25), quantile(0.75), nan
+		};
+		return desc;
+	}
+
+	/**
+	* Representative values and counts of non-empty buckets,
+	* for instance for the weighted functions of Stats.hpp.
+	*
+	* @param values Output representative values of buckets.
+	* @param counts Output counts of buckets.
+	*/
+	void get_buckets(std::vector<double>& values, std::vector<uint64_t>& counts) const
+	{
+		values.clear(), counts.clear();
+		for (size_t i = 0; i < _counts.size(); ++i)
+		{
+			uint64_t c = _counts[i].load(std::memory_order_relaxed);
+			if (c > 0)
+			{
+				values.push_back(bucket_value(i));
+				counts.push_back(c);
+			}
+		}
+	}
+
+protected:
+
+	/**
+	* Bucket of a value: 0 for values lower than min_value, and `1 + ceil(log_gamma(x / min_value))` otherwise.
+	*/
+	size_t bucket(double x) const
+	{
+		if (!(x >= _min_value))
+			return 0;
+		double key = std::ceil(std::log(x / _min_value) * _inv_log_gamma);
+		return std::min(static_cast<size_t>(key) + 1, _counts.size() - 1);
+	}
+
+	/**
+	* Representative value of a bucket, with a relative error lower than alpha for its values.
+	*/
+	double bucket_value(size_t i) const
+	{
+		if (i == 0)
+			return 0;
+		return _min_value * 2 * std::pow(_gamma, static_cast<double>(i - 1)) / (_gamma + 1);
+	}
+
+	/**
+	* Shift of sums, ie the first recorded value, set to `x` if no value was recorded yet.
+	*/
+	double get_shift(double x)
+	{
+		double shift = _shift.load(std::memory_order_relaxed);
+		if (shift != shift && _shift.compare_exchange_strong(shift, x, std::memory_order_relaxed))
+			return x;
+		return shift;
+	}
+
+	static void atomic_add(std::atomic<double>& a, double x)
+	{
+		double v = a.load(std::memory_order_relaxed);
+		while (!a.compare_exchange_weak(v, v + x, std::memory_order_relaxed)) {}
+	}
+
+	double _relative_accuracy, _min_value, _max_value;
+	double _gamma, _inv_log_gamma;
+
+	std::vector<std::atomic<uint64_t>> _counts;
+	std::atomic<uint64_t> _count;
+	std::atomic<double> _sum, _sum2, _shift, _min, _max;
+};
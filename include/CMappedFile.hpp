@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define STATS_MAPPED_FILE_MMAP 1
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+/**
+* Read-only file mapped in memory.
+*
+* On POSIX systems, the file is memory-mapped with a sequential access hint,
+* so that pages are read ahead by the kernel while they are consumed.
+* On other systems, the file is read into a buffer aligned on 8 bytes.
+*/
+class MappedFile
+{
+public:
+
+	/**
+	* Map a file.
+	*
+	* @param path Path of the input file.
+	*/
+	explicit MappedFile(const std::string& path)
+		: _data(nullptr), _size(0)
+	{
+#ifdef STATS_MAPPED_FILE_MMAP
+		int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			throw std::runtime_error("File can not be opened: " + path);
+		struct stat st;
+		if (::fstat(fd, &st) != 0)
+		{
+			::close(fd);
+			throw std::runtime_error("File can not be opened: " + path);
+		}
+		_size = static_cast<size_t>(st.st_size);
+		if (_size > 0)
+		{
+			void* map = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (map == MAP_FAILED)
+			{
+				::close(fd);
+				throw std::runtime_error("File can not be mapped: " + path);
+			}
+			::madvise(map, _size, MADV_SEQUENTIAL);
+			_data = static_cast<const char*>(map);
+		}
+		::close(fd);
+#else
+		std::ifstream is(path.c_str(), std::ios::binary | std::ios::ate);
+		if (!is)
+			throw std::runtime_error("File can not be opened: " + path);
+		_size = static_cast<size_t>(is.tellg());
+		_buffer.resize((_size + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+		is.seekg(0);
+		is.read(reinterpret_cast<char*>(_buffer.data()), static_cast<std::streamsize>(_size));
+		_data = reinterpret_cast<const char*>(_buffer.data());
+#endif
+	}
+
+	~MappedFile()
+	{
+#ifdef STATS_MAPPED_FILE_MMAP
+		if (_data != nullptr)
+			::munmap(const_cast<char*>(_data), _size);
+#endif
+	}
+
+	const char* data() const { return _data; }
+
+	size_t size() const { return _size; }
+
+protected:
+
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char* _data;
+	size_t _size;
+#ifndef STATS_MAPPED_FILE_MMAP
+	std::vector<uint64_t> _buffer;
+#endif
+};
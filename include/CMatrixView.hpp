@@ -0,0 +1,130 @@
+#pragma once
+
+#include <stdexcept>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <type_traits>
+#include "CArrayView.hpp"
+
+
+/**
+* Two-dimensional view of values, without copy, for row-major or column-major matrices.
+*
+* The value `(i, j)` is at `data[i * row_stride + j * col_stride]`.
+* Like `ArrayView`, a matrix view either refers to foreign memory, read-only for a const data type,
+* or owns a row-major buffer.
+* Rows and columns are strided views, consumable by all functions of Maths.hpp and Stats.hpp,
+* and Stats.hpp provides axis-aware reductions and transformations.
+*
+* @tparam ValType The numeric data type of the values, const for read-only values.
+*/
+template<typename ValType>
+class MatrixView
+{
+public:
+
+	typedef typename std::remove_const<ValType>::type value_type;
+
+	/**
+	* Create empty view.
+	*/
+	MatrixView() : _data(nullptr), _rows(0), _cols(0), _row_stride(0), _col_stride(1) {}
+
+	/**
+	* Create view of foreign memory.
+	*
+	* @param data Pointer to the value `(0, 0)`, to const values for a read-only view.
+	* @param rows, cols Numbers of rows and of columns.
+	* @param row_stride Number of values between two consecutive rows, `cols` for a row-major matrix.
+	* @param col_stride Number of values between two consecutive columns, 1 for a row-major matrix.
+	*/
+	MatrixView(ValType* data, size_t rows, size_t cols, std::ptrdiff_t row_stride, std::ptrdiff_t col_stride = 1)
+		: _data(data), _rows(rows), _cols(cols), _row_stride(row_stride), _col_stride(col_stride)
+	{}
+
+	/**
+	* Create view of a row-major matrix in foreign memory.
+	*
+	* @param data Pointer to the value `(0, 0)`, to const values for a read-only view.
+	* @param rows, cols Numbers of rows and of columns.
+	*/
+	MatrixView(ValType* data, size_t rows, size_t cols)
+		: _data(data), _rows(rows), _cols(cols),
+		_row_stride(static_cast<std::ptrdiff_t>(cols)), _col_stride(1)
+	{}
+
+	/**
+	* Create view owning a row-major buffer of value-initialized values.
+	*
+	* @param rows, cols Numbers of rows and of columns.
+	*/
+	MatrixView(size_t rows, size_t cols)
+		: _owned(std::make_shared<std::vector<value_type>>(rows * cols)), _rows(rows), _cols(cols),
+		_row_stride(static_cast<std::ptrdiff_t>(cols)), _col_stride(1)
+	{
+		_data = _owned->data();
+	}
+
+	size_t rows() const { return _rows; }
+
+	size_t cols() const { return _cols; }
+
+	size_t size() const { return _rows * _cols; }
+
+	std::ptrdiff_t row_stride() const { return _row_stride; }
+
+	std::ptrdiff_t col_stride() const { return _col_stride; }
+
+	const value_type* data() const { return _data; }
+
+	ValType* data() { return _data; }
+
+	bool is_owner() const { return _owned != nullptr; }
+
+	ValType& operator()(size_t i, size_t j) { return _data[i * _row_stride + j * _col_stride]; }
+
+	const value_type& operator()(size_t i, size_t j) const { return _data[i * _row_stride + j * _col_stride]; }
+
+	/**
+	* View of a row, valid as long as the memory of the matrix.
+	*
+	* @param i Index of the row.
+	*/
+	StridedView<ValType> row(size_t i) const
+	{
+		if (i >= _rows)
+			throw std::invalid_argument("Index of row is out of range.");
+		return StridedView<ValType>(_data + i * _row_stride, _cols, _col_stride);
+	}
+
+	/**
+	* View of a column, valid as long as the memory of the matrix.
+	*
+	* @param j Index of the column.
+	*/
+	StridedView<ValType> col(size_t j) const
+	{
+		if (j >= _cols)
+			throw std::invalid_argument("Index of column is out of range.");
+		return StridedView<ValType>(_data + j * _col_stride, _rows, _row_stride);
+	}
+
+	/**
+	* Transposed view, without copy.
+	*/
+	MatrixView transpose() const
+	{
+		MatrixView t(*this);
+		std::swap(t._rows, t._cols);
+		std::swap(t._row_stride, t._col_stride);
+		return t;
+	}
+
+protected:
+
+	std::shared_ptr<std::vector<value_type>> _owned;
+	ValType* _data;
+	size_t _rows, _cols;
+	std::ptrdiff_t _row_stride, _col_stride;
+};
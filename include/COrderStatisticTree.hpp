@@ -0,0 +1,273 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <random>
+#include <vector>
+
+
+/**
+* Order-statistic tree, for dynamic data sets where values are inserted and erased.
+*
+* Values are stored in a randomized balanced binary search tree (treap),
+* each node counting its duplicates and the size of its subtree,
+* so that insertion, deletion, k-th order statistic, median and rank are computed in O(log n).
+* Nodes are stored contiguously and recycled, without an allocation per value.
+*/
+class OrderStatisticTree
+{
+public:
+
+	/**
+	* Create empty tree.
+	*/
+	OrderStatisticTree()
+		: _nodes(1, Node()), _root(NIL), _rng(42)
+	{}
+
+	size_t size() const { return _nodes[_root].size; }
+
+	bool empty() const { return size() == 0; }
+
+	/**
+	* Remove all values.
+	*/
+	void clear()
+	{
+		_nodes.resize(1);
+		_free.clear();
+		_root = NIL;
+	}
+
+	/**
+	* Insert a value, in O(log n).
+	*
+	* @param x Input value, not NaN, which has no order and could not be erased.
+	*/
+	void insert(double x)
+	{
+		if (x != x)
+			throw std::invalid_argument("Value must not be NaN.");
+		_root = insert(_root, x);
+	}
+
+	/**
+	* Erase one occurrence of a value, in O(log n).
+	*
+	* @param x Input value.
+	*
+	* @return Boolean checking if `x` was found and erased, false for NaN.
+	*/
+	bool erase(double x)
+	{
+		if (x != x)
+			return false;
+		bool is_found = false;
+		_root = erase(_root, x, is_found);
+		return is_found;
+	}
+
+	/**
+	* K-th order statistic, in O(log n).
+	*
+	* @param k Rank of the order statistic, starting from 0.
+	*
+	* @return K-th smallest value.
+	*/
+	double kth(size_t k) const
+	{
+		if (k >= size())
+			throw std::invalid_argument("Rank is greater than the number of values.");
+
+		unsigned int t = _root;
+		while (true)
+		{
+			const Node& node = _nodes[t];
+			size_t left_size = _nodes[node.left].size;
+			if (k < left_size)
+				t = node.left;
+			else if (k < left_size + node.count)
+				return node.value;
+			else
+				k -= left_size + node.count, t = node.right;
+		}
+	}
+
+	/**
+	* Median, as computed by `Stats::median`, in O(log n).
+	*/
+	double median() const
+	{
+		size_t n = size();
+		if (n == 0)
+			throw std::invalid_argument("Input has not enough values for median.");
+
+		if (n % 2 == 0)
+			return (kth(n / 2 - 1) + kth(n / 2)) / 2;
+		return kth(n / 2);
+	}
+
+	/**
+	* Quantile, linearly interpolated between closest ranks, in O(log n).
+	*
+	* @param q Quantile, in [0, 1].
+	*/
+	double quantile(double q) const
+	{
+		if (!(q >= 0 && q <= 1))
+			throw std::invalid_argument("Quantile must be in [0, 1].");
+		if (empty())
+			throw std::invalid_argument("Input has not enough values for quantile.");
+
+		double h = (size() - 1) * q;
+		size_t lo = static_cast<size_t>(h);
+		if (h == lo)
+			return kth(lo);
+		double x_lo = kth(lo);
+		return x_lo + (h - lo) * (kth(lo + 1) - x_lo);
+	}
+
+	/**
+	* Rank of a value, in O(log n).
+	*
+	* @param x Input value.
+	*
+	* @return Number of values strictly less than `x`.
+	*/
+	size_t rank(double x) const
+	{
+		size_t r = 0;
+		unsigned int t = _root;
+		while (t != NIL)
+		{
+			const Node& node = _nodes[t];
+			if (x <= node.value)
+				t = node.left;
+			else
+				r += _nodes[node.left].size + node.count, t = node.right;
+		}
+		return r;
+	}
+
+protected:
+
+	static const unsigned int NIL = 0;
+
+	struct Node
+	{
+		Node() : value(0), priority(0), count(0), size(0), left(NIL), right(NIL) {}
+
+		double value;
+		unsigned int priority;
+		size_t count, size;
+		unsigned int left, right;
+	};
+
+	void update(unsigned int t)
+	{
+		Node& node = _nodes[t];
+		node.size = _nodes[node.left].size + node.count + _nodes[node.right].size;
+	}
+
+	unsigned int rotate_right(unsigned int t)
+	{
+		unsigned int l = _nodes[t].left;
+		_nodes[t].left = _nodes[l].right;
+		_nodes[l].right = t;
+		update(t), update(l);
+		return l;
+	}
+
+	unsigned int rotate_left(unsigned int t)
+	{
+		unsigned int r = _nodes[t].right;
+		_nodes[t].right = _nodes[r].left;
+		_nodes[r].left = t;
+		update(t), update(r);
+		return r;
+	}
+
+	unsigned int insert(unsigned int t, double x)
+	{
+		if (t == NIL)
+		{
+			Node node;
+			node.value = x, node.priority = static_cast<unsigned int>(_rng()), node.count = 1, node.size = 1;
+			if (!_free.empty())
+			{
+				t = _free.back();
+				_free.pop_back();
+				_nodes[t] = node;
+			}
+			else
+			{
+				t = static_cast<unsigned int>(_nodes.size());
+				_nodes.push_back(node);
+			}
+			return t;
+		}
+
+		if (x == _nodes[t].value)
+			_nodes[t].count++;
+		else if (x < _nodes[t].value)
+		{
+			unsigned int l = insert(_nodes[t].left, x);
+			_nodes[t].left = l;
+			if (_nodes[l].priority > _nodes[t].priority)
+				return rotate_right(t);
+		}
+		else
+		{
+			unsigned int r = insert(_nodes[t].right, x);
+			_nodes[t].right = r;
+			if (_nodes[r].priority > _nodes[t].priority)
+				return rotate_left(t);
+		}
+		update(t);
+		return t;
+	}
+
+	unsigned int erase(unsigned int t, double x, bool& is_found)
+	{
+		if (t == NIL)
+			return NIL;
+
+		if (x < _nodes[t].value)
+			_nodes[t].left = erase(_nodes[t].left, x, is_found);
+		else if (x > _nodes[t].value)
+			_nodes[t].right = erase(_nodes[t].right, x, is_found);
+		else if (_nodes[t].count > 1)
+		{
+			_nodes[t].count--;
+			is_found = true;
+		}
+		else
+		{
+			unsigned int l = _nodes[t].left, r = _nodes[t].right;
+			if (l == NIL || r == NIL)
+			{
+				_free.push_back(t);
+				is_found = true;
+				return l == NIL ? r : l;
+			}
+			// rotate the node down, below its child of highest priority
+			if (_nodes[l].priority > _nodes[r].priority)
+			{
+				t = rotate_right(t);
+				_nodes[t].right = erase(_nodes[t].right, x, is_found);
+			}
+			else
+			{
+				t = rotate_left(t);
+				_nodes[t].left = erase(_nodes[t].left, x, is_found);
+			}
+		}
+		update(t);
+		return t;
+	}
+
+	std::vector<Node> _nodes;
+	std::vector<unsigned int> _free;
+	unsigned int _root;
+	std::minstd_rand _rng;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include "CStreamingQuantile.hpp"
+
+
+/**
+* Streaming outlier detector, using robust z-scores.
+*
+* Median and median absolute deviation are approximated incrementally by two P² estimators,
+* the second one on absolute deviations from the current median estimate,
+* so each value is scored and flagged in O(1) time and memory.
+*/
+class OutlierDetector
+{
+public:
+
+	/**
+	* Create outlier detector.
+	*
+	* @param threshold Threshold on the absolute robust z-score above which a value is an outlier.
+	* @param warmup Number of first values which are never flagged as outliers.
+	*/
+	OutlierDetector(double threshold = 3.5, size_t warmup = 10)
+		: _median(0.5), _mad(0.5)
+	{
+		if (!(threshold > 0))
+			throw std::invalid_argument("Parameter threshold must be positive.");
+
+		_threshold = threshold;
+		_warmup = warmup;
+		_outlier_count = 0;
+	}
+
+	size_t size() const { return _median.size(); }
+
+	size_t get_outlier_count() const { return _outlier_count; }
+
+	double get_median() const { return _median.get_quantile(); }
+
+	/**
+	* Estimated median absolute deviation, rescaled to be consistent with
+	* the standard deviation of normally distributed values.
+	*/
+	double get_mad() const { return 1.4826 * _mad.get_quantile(); }
+
+	/**
+	* Robust z-score of a value, wrt. values pushed so far.
+	*
+	* @param x Input value.
+	*
+	* @return Robust z-score `(x - median) / (1.4826 * mad)`.
+	*/
+	double score(double x) const
+	{
+		if (size() == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double dev = x - get_median(), mad = get_mad();
+		if (mad > 0)
+			return dev / mad;
+		if (dev == 0)
+			return 0;
+		return dev > 0 ? std::numeric_limits<double>::infinity() : -std::numeric_limits<double>::infinity();
+	}
+
+	/**
+	* Score a value wrt. values pushed so far, then push it.
+	*
+	* @param x Input value.
+	*
+	* @return Boolean checking if `x` is an outlier.
+	*/
+	bool push(double x)
+	{
+		bool is_outlier = size() >= _warmup && std::fabs(score(x)) > _threshold;
+		if (is_outlier)
+			_outlier_count++;
+
+		_median.push(x);
+		_mad.push(std::fabs(x - get_median()));
+		return is_outlier;
+	}
+
+protected:
+
+	StreamingQuantile _median, _mad;
+	double _threshold;
+	size_t _warmup;
+	size_t _outlier_count;
+};
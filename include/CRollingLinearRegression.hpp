@@ -0,0 +1,212 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <vector>
+
+
+/**
+* Rolling simple linear regression, using ordinary least squares on a sliding window.
+*
+* Windowed co-moments are updated in O(1) when a point enters or leaves the window,
+* and are periodically recomputed from the window to bound floating-point drift.
+*
+* @see [pandas.core.window.rolling.Rolling.cov](https://pandas.pydata.org/docs/reference/api/pandas.core.window.rolling.Rolling.cov.html)
+*/
+class RollingLinearRegression
+{
+public:
+
+	/**
+	* Create rolling linear model.
+	*
+	* @param window Number of points of the sliding window.
+	* @param resync_period Number of updates between two exact recomputations of co-moments,
+	* 0 to disable resynchronization.
+	*/
+	RollingLinearRegression(size_t window, size_t resync_period = 1024)
+	{
+		if (window < 2)
+			throw std::invalid_argument("Parameter window must be greater than 1.");
+
+		_window = window;
+		_resync_period = resync_period;
+		_x.resize(window), _y.resize(window);
+		reset();
+	}
+
+	/**
+	* Remove all points of the window, and all fitted series.
+	*/
+	void reset()
+	{
+		_head = 0, _size = 0, _updates = 0;
+		_mx = 0, _my = 0, _cxx = 0, _cyy = 0, _cxy = 0;
+		_coeffs.clear(), _intercepts.clear(), _scores.clear();
+	}
+
+	size_t get_window() const { return _window; }
+
+	size_t size() const { return _size; }
+
+	bool is_full() const { return _size == _window; }
+
+	/**
+	* Push a point in the window, removing the oldest point when the window is full.
+	*
+	* @param x Training value.
+	* @param y Target value.
+	*/
+	void push(double x, double y)
+	{
+		if (_size == _window)
+		{
+			remove(_x[_head], _y[_head]);
+			_x[_head] = x, _y[_head] = y;
+			_head = (_head + 1) % _window;
+		}
+		else
+		{
+			_x[(_head + _size) % _window] = x, _y[(_head + _size) % _window] = y;
+		}
+		add(x, y);
+
+		if (_resync_period > 0 && ++_updates >= _resync_period)
+			resync();
+	}
+
+	/**
+	* Coefficient of the linear model fitted on the current window.
+	*/
+	double get_coeff() const
+	{
+		if (_size < 2 || _cxx <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _cxy / _cxx;
+	}
+
+	/**
+	* Intercept of the linear model fitted on the current window.
+	*/
+	double get_intercept() const
+	{
+		return _my - get_coeff() * _mx;
+	}
+
+	/**
+	* Coefficient of determination of the linear model on the current window.
+	*/
+	double get_score() const
+	{
+		if (_size < 2 || _cxx <= 0 || _cyy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return (_cxy * _cxy) / (_cxx * _cyy);
+	}
+
+	/**
+	* Fit linear models on all sliding windows, in one pass.
+	*
+	* Series of coefficients, intercepts and R² are computed for each full window,
+	* ie for `x.size() - window + 1` windows.
+	*
+	* @tparam ContType The type of the sequence containers.
+	*
+	* @param x Input sequence container containing training values.
+	* @param y Input sequence container containing target values.
+	*/
+	template<typename ContType>
+	void fit(const ContType& x, const ContType& y)
+	{
+		size_t size = x.size();
+		if (size != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size < _window)
+			throw std::invalid_argument("Inputs have not enough values for fit.");
+
+		reset();
+		_coeffs.reserve(size - _window + 1);
+		_intercepts.reserve(size - _window + 1);
+		_scores.reserve(size - _window + 1);
+
+		auto x_it = x.begin();
+		auto y_it = y.begin();
+		for (; x_it != x.end(); ++x_it, ++y_it)
+		{
+			push(static_cast<double>(*x_it), static_cast<double>(*y_it));
+			if (is_full())
+			{
+				_coeffs.push_back(get_coeff());
+				_intercepts.push_back(get_intercept());
+				_scores.push_back(get_score());
+			}
+		}
+	}
+
+	const std::vector<double>& get_coeffs() const { return _coeffs; }
+
+	const std::vector<double>& get_intercepts() const { return _intercepts; }
+
+	const std::vector<double>& get_scores() const { return _scores; }
+
+protected:
+
+	void add(double x, double y)
+	{
+		_size++;
+		double dx = x - _mx, dy = y - _my;
+		_mx += dx / _size;
+		_my += dy / _size;
+		_cxx += dx * (x - _mx);
+		_cyy += dy * (y - _my);
+		_cxy += dx * (y - _my);
+	}
+
+	void remove(double x, double y)
+	{
+		if (_size == 1)
+		{
+			_size = 0, _mx = 0, _my = 0, _cxx = 0, _cyy = 0, _cxy = 0;
+			return;
+		}
+
+		_size--;
+		double dx = x - _mx, dy = y - _my;
+		_mx -= dx / _size;
+		_my -= dy / _size;
+		_cxx -= dx * (x - _mx);
+		_cyy -= dy * (y - _my);
+		_cxy -= dx * (y - _my);
+	}
+
+	/**
+	* Recompute co-moments of the window, using two passes.
+	*/
+	void resync()
+	{
+		_updates = 0;
+		if (_size == 0)
+			return;
+
+		double sx = 0, sy = 0;
+		for (size_t i = 0; i < _size; ++i)
+		{
+			size_t j = (_head + i) % _window;
+			sx += _x[j], sy += _y[j];
+		}
+		_mx = sx / _size, _my = sy / _size;
+
+		_cxx = 0, _cyy = 0, _cxy = 0;
+		for (size_t i = 0; i < _size; ++i)
+		{
+			size_t j = (_head + i) % _window;
+			double dx = _x[j] - _mx, dy = _y[j] - _my;
+			_cxx += dx * dx, _cyy += dy * dy, _cxy += dx * dy;
+		}
+	}
+
+	size_t _window, _resync_period;
+	std::vector<double> _x, _y;
+	size_t _head, _size, _updates;
+	double _mx, _my, _cxx, _cyy, _cxy;
+	std::vector<double> _coeffs, _intercepts, _scores;
+};
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <limits>
+#include <cmath>
+#include <algorithm>
+
+
+/**
+* Running central moments, updated in O(1) per value and mergeable.
+*
+* Count, minimum, maximum, mean and sums of powers of deviations up to order 4
+* are updated with the numerically stable formulas of Welford and Terriberry,
+* and merged with the pairwise formulas of Chan and Pébay.
+*
+* @see [Algorithms for calculating variance](https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance)
+*/
+class RunningMoments
+{
+public:
+
+	/**
+	* Create empty accumulator.
+	*/
+	RunningMoments() { reset(); }
+
+	/**
+	* Remove all values.
+	*/
+	void reset()
+	{
+		_count = 0;
+		_min = std::numeric_limits<double>::infinity();
+		_max = -std::numeric_limits<double>::infinity();
+		_mean = 0, _m2 = 0, _m3 = 0, _m4 = 0;
+	}
+
+	/**
+	* Push a value.
+	*
+	* @param x Input value.
+	*/
+	void push(double x)
+	{
+		double n1 = static_cast<double>(_count);
+		_count++;
+		double n = static_cast<double>(_count);
+
+		double delta = x - _mean;
+		double delta_n = delta / n;
+		double delta_n2 = delta_n * delta_n;
+		double term1 = delta * delta_n * n1;
+
+		_mean += delta_n;
+		_m4 += term1 * delta_n2 * (n * n - 3 * n + 3) + 6 * delta_n2 * _m2 - 4 * delta_n * _m3;
+		_m3 += term1 * delta_n * (n - 2) - 3 * delta_n * _m2;
+		_m2 += term1;
+
+		_min = std::min(_min, x);
+		_max = std::max(_max, x);
+	}
+
+	/**
+	* Merge the values of another accumulator.
+	*
+	* @param other Accumulator to merge.
+	*/
+	void merge(const RunningMoments& other)
+	{
+		if (other._count == 0)
+			return;
+		if (_count == 0)
+		{
+			*this = other;
+			return;
+		}
+
+		double na = static_cast<double>(_count), nb = static_cast<double>(other._count);
+		double n = na + nb;
+		double delta = other._mean - _mean;
+		double delta2 = delta * delta, delta3 = delta2 * delta, delta4 = delta2 * delta2;
+
+		double m2 = _m2 + other._m2 + delta2 * na * nb / n;
+		double m3 = _m3 + other._m3 + delta3 * na * nb * (na - nb) / (n * n)
+			+ 3 * delta * (na * other._m2 - nb * _m2) / n;
+		double m4 = _m4 + other._m4 + delta4 * na * nb * (na * na - na * nb + nb * nb) / (n * n * n)
+			+ 6 * delta2 * (na * na * other._m2 + nb * nb * _m2) / (n * n)
+			+ 4 * delta * (na * other._m3 - nb * _m3) / n;
+
+		_mean += delta * nb / n;
+		_m2 = m2, _m3 = m3, _m4 = m4;
+		_count += other._count;
+		_min = std::min(_min, other._min);
+		_max = std::max(_max, other._max);
+	}
+
+	size_t size() const { return _count; }
+
+	double get_min() const { return _count > 0 ? _min : std::numeric_limits<double>::quiet_NaN(); }
+
+	double get_max() const { return _count > 0 ? _max : std::numeric_limits<double>::quiet_NaN(); }
+
+	double get_sum() const { return _mean * _count; }
+
+	double get_mean() const { return _count > 0 ? _mean : std::numeric_limits<double>::quiet_NaN(); }
+
+	/**
+	* Sum of squared deviations from the mean.
+	*/
+	double get_m2() const { return _m2; }
+
+	/**
+	* Variance of values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_var(size_t ddof = 0) const
+	{
+		if (_count <= ddof)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _m2 / (_count - ddof);
+	}
+
+	/**
+	* Standard deviation of values.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_std(size_t ddof = 0) const
+	{
+		return std::sqrt(get_var(ddof));
+	}
+
+	/**
+	* Skewness of values, as computed by `Stats::skewness`.
+	*/
+	double get_skewness() const
+	{
+		return (_m3 * std::sqrt(static_cast<double>(_count))) / std::pow(_m2, 1.5);
+	}
+
+	/**
+	* Non-normalized kurtosis of values, as computed by `Stats::kurtosis`.
+	*/
+	double get_kurtosis() const
+	{
+		return (_m4 * _count) / (_m2 * _m2);
+	}
+
+protected:
+
+	size_t _count;
+	double _min, _max;
+	double _mean, _m2, _m3, _m4;
+};
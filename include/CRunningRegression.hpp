@@ -0,0 +1,138 @@
+#pragma once
+
+#include <limits>
+#include <cmath>
+
+
+/**
+* Running sufficient statistics of a simple linear regression, updated in O(1) per point and mergeable.
+*
+* Count, means and co-moments of points are updated with the formulas of Welford,
+* and merged with the pairwise formulas of Chan, so that regressions of chunks
+* computed separately, for instance in parallel, are combined exactly.
+*
+* @see [Algorithms for calculating variance](https://en.wikipedia.org/wiki/Algorithms_for_calculating_variance)
+*/
+class RunningRegression
+{
+public:
+
+	/**
+	* Create empty accumulator.
+	*/
+	RunningRegression() { reset(); }
+
+	/**
+	* Remove all points.
+	*/
+	void reset()
+	{
+		_count = 0;
+		_mx = 0, _my = 0, _cxx = 0, _cyy = 0, _cxy = 0;
+	}
+
+	/**
+	* Push a point.
+	*
+	* @param x Training value.
+	* @param y Target value.
+	*/
+	void push(double x, double y)
+	{
+		_count++;
+		double dx = x - _mx, dy = y - _my;
+		_mx += dx / _count;
+		_my += dy / _count;
+		_cxx += dx * (x - _mx);
+		_cyy += dy * (y - _my);
+		_cxy += dx * (y - _my);
+	}
+
+	/**
+	* Merge the points of another accumulator.
+	*
+	* @param other Accumulator to merge.
+	*/
+	void merge(const RunningRegression& other)
+	{
+		if (other._count == 0)
+			return;
+		if (_count == 0)
+		{
+			*this = other;
+			return;
+		}
+
+		double na = static_cast<double>(_count), nb = static_cast<double>(other._count);
+		double n = na + nb;
+		double dx = other._mx - _mx, dy = other._my - _my;
+
+		_cxx += other._cxx + dx * dx * na * nb / n;
+		_cyy += other._cyy + dy * dy * na * nb / n;
+		_cxy += other._cxy + dx * dy * na * nb / n;
+		_mx += dx * nb / n;
+		_my += dy * nb / n;
+		_count += other._count;
+	}
+
+	size_t size() const { return _count; }
+
+	double get_mean_x() const { return _count > 0 ? _mx : std::numeric_limits<double>::quiet_NaN(); }
+
+	double get_mean_y() const { return _count > 0 ? _my : std::numeric_limits<double>::quiet_NaN(); }
+
+	/**
+	* Covariance of points.
+	*
+	* @param ddof Degree of freedom.
+	*/
+	double get_cov(size_t ddof = 0) const
+	{
+		if (_count <= ddof)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _cxy / (_count - ddof);
+	}
+
+	/**
+	* Pearson correlation coefficient of points.
+	*/
+	double get_corr() const
+	{
+		if (_count < 2 || _cxx <= 0 || _cyy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _cxy / std::sqrt(_cxx * _cyy);
+	}
+
+	/**
+	* Coefficient of the linear model fitted by ordinary least squares.
+	*/
+	double get_coeff() const
+	{
+		if (_count < 2 || _cxx <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return _cxy / _cxx;
+	}
+
+	/**
+	* Intercept of the linear model fitted by ordinary least squares.
+	*/
+	double get_intercept() const
+	{
+		return _my - get_coeff() * _mx;
+	}
+
+	/**
+	* Coefficient of determination of the linear model.
+	*/
+	double get_score() const
+	{
+		if (_count < 2 || _cxx <= 0 || _cyy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return (_cxy * _cxy) / (_cxx * _cyy);
+	}
+
+protected:
+
+	size_t _count;
+	double _mx, _my, _cxx, _cyy, _cxy;
+};
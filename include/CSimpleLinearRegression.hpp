@@ -1,3 +1,5 @@
+#pragma once
+
 #include <stdexcept>
 #include <limits>
 #include <numeric>
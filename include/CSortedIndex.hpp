@@ -0,0 +1,185 @@
+#pragma once
+
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include <thread>
+
+
+/**
+* Sorted index of a static data set, for repeated order-statistic queries.
+*
+* Values are sorted once, in parallel, then quantiles are answered in O(1),
+* ranks and empirical cumulative distribution function in O(log n),
+* and median absolute deviation by a merge-walk around the median.
+*/
+class SortedIndex
+{
+public:
+
+	/**
+	* Create sorted index, copying and sorting values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param n_threads Number of threads used for sorting, 0 for the number of hardware threads.
+	*/
+	template<typename ContType>
+	SortedIndex(const ContType& x, unsigned int n_threads = 0)
+		: _sorted(x.begin(), x.end())
+	{
+		if (_sorted.size() == 0)
+			throw std::invalid_argument("Input has not enough values for SortedIndex.");
+
+		if (n_threads == 0)
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		parallel_sort(_sorted, n_threads);
+		_has_mad = false, _mad = 0;
+	}
+
+	size_t size() const { return _sorted.size(); }
+
+	const std::vector<double>& sorted() const { return _sorted; }
+
+	double min() const { return _sorted.front(); }
+
+	double max() const { return _sorted.back(); }
+
+	/**
+	* Quantile, linearly interpolated between closest ranks, in O(1).
+	*
+	* @param q Quantile, in [0, 1].
+	*/
+	double quantile(double q) const
+	{
+		if (q < 0 || q > 1)
+			throw std::invalid_argument("Quantile must be in [0, 1].");
+
+		double h = (_sorted.size() - 1) * q;
+		size_t lo = static_cast<size_t>(h);
+		if (h == lo)
+			return _sorted[lo];
+		return _sorted[lo] + (h - lo) * (_sorted[lo + 1] - _sorted[lo]);
+	}
+
+	/**
+	* Median, as computed by `Stats::median`, in O(1).
+	*/
+	double median() const
+	{
+		size_t size = _sorted.size();
+		if (size % 2 == 0)
+			return (_sorted[size / 2 - 1] + _sorted[size / 2]) / 2;
+		return _sorted[size / 2];
+	}
+
+	/**
+	* Rank of a value, in O(log n).
+	*
+	* @param v Input value.
+	*
+	* @return Number of values strictly less than `v`.
+	*/
+	size_t rank(double v) const
+	{
+		return std::lower_bound(_sorted.begin(), _sorted.end(), v) - _sorted.begin();
+	}
+
+	/**
+	* Empirical cumulative distribution function, in O(log n).
+	*
+	* @param v Input value.
+	*
+	* @return Proportion of values less than or equal to `v`.
+	*/
+	double ecdf(double v) const
+	{
+		size_t c = std::upper_bound(_sorted.begin(), _sorted.end(), v) - _sorted.begin();
+		return static_cast<double>(c) / _sorted.size();
+	}
+
+	/**
+	* Median absolute deviation, as computed by `Stats::median_abs_deviation`.
+	*
+	* Absolute deviations of values below and above the median are two sorted sequences,
+	* merged until reaching the middle; the result is cached.
+	*
+	* @param is_rescaled Boolean to rescale output, in order to be an estimator consistent
+	* for the estimation of the standard deviation of normally distributed values.
+	*/
+	double median_abs_deviation(bool is_rescaled = false) const
+	{
+		if (!_has_mad)
+		{
+			size_t size = _sorted.size(), split = size / 2;
+			double med = median();
+
+			// left deviations increase from split - 1 downwards, right ones from split upwards
+			size_t left = split, right = split;
+			double dev = 0, dev_prev = 0;
+			for (size_t k = 0; k <= size / 2; ++k)
+			{
+				dev_prev = dev;
+				if (right == size || (left > 0 && med - _sorted[left - 1] <= _sorted[right] - med))
+					dev = med - _sorted[--left];
+				else
+					dev = _sorted[right++] - med;
+			}
+			_mad = (size % 2 == 0) ? (dev_prev + dev) / 2 : dev;
+			_has_mad = true;
+		}
+		return is_rescaled ? _mad * 1.4826 : _mad;
+	}
+
+	/**
+	* Sort values, sorting chunks in parallel then merging them pairwise in parallel.
+	*
+	* @param x Values to sort.
+	* @param n_threads Number of threads.
+	*/
+	static void parallel_sort(std::vector<double>& x, unsigned int n_threads)
+	{
+		const size_t min_chunk = 1 << 14;
+		size_t n_chunks = std::min<size_t>(n_threads, x.size() / min_chunk);
+		if (n_chunks <= 1)
+		{
+			std::sort(x.begin(), x.end());
+			return;
+		}
+
+		std::vector<size_t> bounds(n_chunks + 1);
+		for (size_t c = 0; c <= n_chunks; ++c)
+			bounds[c] = x.size() * c / n_chunks;
+
+		std::vector<std::thread> threads;
+		for (size_t c = 0; c < n_chunks; ++c)
+			threads.push_back(std::thread([&x, &bounds, c]() {
+				std::sort(x.begin() + bounds[c], x.begin() + bounds[c + 1]);
+			}));
+		for (auto& t : threads)
+			t.join();
+
+		for (size_t width = 1; width < n_chunks; width *= 2)
+		{
+			threads.clear();
+			for (size_t c = 0; c + width < n_chunks; c += 2 * width)
+			{
+				size_t first = bounds[c], middle = bounds[c + width], last = bounds[std::min(c + 2 * width, n_chunks)];
+				threads.push_back(std::thread([&x, first, middle, last]() {
+					std::inplace_merge(x.begin() + first, x.begin() + middle, x.begin() + last);
+				}));
+			}
+			for (auto& t : threads)
+				t.join();
+		}
+	}
+
+protected:
+
+	std::vector<double> _sorted;
+
+	mutable bool _has_mad;
+	mutable double _mad;
+};
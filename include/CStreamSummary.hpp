@@ -0,0 +1,173 @@
+#pragma once
+
+#include <stdexcept>
+#include <memory>
+#include <string>
+#include <vector>
+#include "CChunkedReader.hpp"
+#include "CRunningMoments.hpp"
+#include "CRunningRegression.hpp"
+#include "CLogHistogram.hpp"
+
+
+/**
+* Summary of rows of values, accumulated chunk by chunk with a memory footprint independent of the number of rows:
+* running moments and a log-bucketed histogram of each column, sketching its distribution with quantiles
+* of bounded relative error, and running regression of each column on the first one.
+*
+* Chunks contain whole rows stored row-major, like the chunks of `ChunkedReader`.
+* NaN values are ignored, as well as the points of regressions with a NaN value.
+* Summaries of parts of a data set, for instance computed in parallel, are mergeable.
+*/
+class StreamSummary
+{
+public:
+
+	/**
+	* Create empty summary.
+	*
+	* @param n_cols Number of values by row.
+	* @param relative_accuracy Relative accuracy of the quantiles of histograms, in (0, 1).
+	* @param min_value, max_value Range of values recorded with relative accuracy by histograms,
+	* lower values, including negative values, being counted in their zero bucket.
+	*/
+	explicit StreamSummary(
+		size_t n_cols = 1, double relative_accuracy = 0.01, double min_value = 1e-9, double max_value = 1e9
+	)
+		: _n_cols(n_cols), _rows(0), _moments(n_cols), _regressions(n_cols)
+	{
+		if (n_cols == 0)
+			throw std::invalid_argument("Rows must have at least one column.");
+		for (size_t j = 0; j < n_cols; ++j)
+			_histograms.emplace_back(new LogHistogram(relative_accuracy, min_value, max_value));
+	}
+
+	size_t get_n_cols() const { return _n_cols; }
+
+	/**
+	* Number of rows pushed.
+	*/
+	size_t rows() const { return _rows; }
+
+	/**
+	* Push a chunk of whole rows.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param chunk Input sequence container, containing whole rows stored row-major.
+	*/
+	template<typename ContType>
+	void push_chunk(const ContType& chunk)
+	{
+		if (chunk.size() % _n_cols != 0)
+			throw std::invalid_argument("Chunk does not contain whole rows.");
+
+		size_t j = 0;
+		double x = 0;
+		for (const auto& e : chunk)
+		{
+			double v = static_cast<double>(e);
+			if (v == v)
+			{
+				_moments[j].push(v);
+				_histograms[j]->record(v);
+			}
+			if (j == 0)
+				x = v;
+			else if (x == x && v == v)
+				_regressions[j].push(x, v);
+			if (++j == _n_cols)
+				j = 0, _rows++;
+		}
+	}
+
+	/**
+	* Merge the rows of another summary, with the same number of columns and parameters of histograms.
+	*
+	* @param other Summary to merge.
+	*/
+	void merge(const StreamSummary& other)
+	{
+		if (other._n_cols != _n_cols)
+			throw std::invalid_argument("Summaries have not the same number of columns.");
+		if (other._histograms[0]->get_relative_accuracy() != _histograms[0]->get_relative_accuracy()
+			|| other._histograms[0]->get_bucket_count() != _histograms[0]->get_bucket_count())
+			throw std::invalid_argument("Histograms have not the same parameters.");
+
+		_rows += other._rows;
+		for (size_t j = 0; j < _n_cols; ++j)
+		{
+			_moments[j].merge(other._moments[j]);
+			_histograms[j]->merge(*other._histograms[j]);
+			_regressions[j].merge(other._regressions[j]);
+		}
+	}
+
+	/**
+	* Running moments of the non-NaN values of a column.
+	*
+	* @param j Index of the column.
+	*/
+	const RunningMoments& get_moments(size_t j) const
+	{
+		if (j >= _n_cols)
+			throw std::invalid_argument("Index of column is out of range.");
+		return _moments[j];
+	}
+
+	/**
+	* Log-bucketed histogram of the non-NaN values of a column, giving approximate quantiles.
+	*
+	* @param j Index of the column.
+	*/
+	const LogHistogram& get_histogram(size_t j) const
+	{
+		if (j >= _n_cols)
+			throw std::invalid_argument("Index of column is out of range.");
+		return *_histograms[j];
+	}
+
+	/**
+	* Running regression of a column, as target, on the first column, as training values.
+	*
+	* @param j Index of the column, greater than 0.
+	*/
+	const RunningRegression& get_regression(size_t j) const
+	{
+		if (j == 0 || j >= _n_cols)
+			throw std::invalid_argument("Index of column is out of range.");
+		return _regressions[j];
+	}
+
+protected:
+
+	size_t _n_cols, _rows;
+	std::vector<RunningMoments> _moments;
+	std::vector<std::unique_ptr<LogHistogram>> _histograms;
+	std::vector<RunningRegression> _regressions;
+};
+
+
+/**
+* Summary of a file, or of the standard input for the path "-", read by `ChunkedReader` in one pass
+* with a prefetch thread, at the bandwidth of the disk and with a memory footprint of two chunks.
+*
+* @tparam ValType The numeric data type of the values of the file.
+*
+* @param path Path of the input file.
+* @param format Format of the values of the file.
+* @param n_cols Number of values by row.
+* @param chunk_rows Number of rows by chunk.
+*
+* @return Moments and histograms of each column, and regressions of each column on the first one.
+*/
+template<typename ValType = double>
+StreamSummary summarize_stream(
+	const std::string& path, StreamFormat format = STREAM_BINARY, size_t n_cols = 1, size_t chunk_rows = 1 << 20
+)
+{
+	StreamSummary summary(n_cols);
+	ChunkedReader<ValType> reader(path, format, chunk_rows, n_cols);
+	reader.for_each([&summary](const ArrayView<ValType>& chunk) { summary.push_chunk(chunk); });
+	return summary;
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <stdexcept>
+#include <limits>
+#include <algorithm>
+
+
+/**
+* Streaming estimation of a quantile in O(1) memory and time per value, using the P² algorithm.
+*
+* Five markers track the minimum, the maximum, the quantile and two intermediate quantiles,
+* their heights being adjusted by piecewise-parabolic interpolation.
+*
+* @see R. Jain and I. Chlamtac, "The P² algorithm for dynamic calculation of quantiles
+* and histograms without storing observations", Communications of the ACM, 1985.
+*/
+class StreamingQuantile
+{
+public:
+
+	/**
+	* Create quantile estimator.
+	*
+	* @param q Quantile to estimate, in [0, 1].
+	*/
+	StreamingQuantile(double q = 0.5)
+	{
+		if (!(q >= 0 && q <= 1))
+			throw std::invalid_argument("Quantile must be in [0, 1].");
+
+		_q = q;
+		_dn[0] = 0, _dn[1] = q / 2, _dn[2] = q, _dn[3] = (1 + q) / 2, _dn[4] = 1;
+		reset();
+	}
+
+	/**
+	* Remove all values.
+	*/
+	void reset()
+	{
+		_count = 0;
+		for (int i = 0; i < 5; ++i)
+		{
+			_h[i] = 0;
+			_n[i] = i + 1;
+			_np[i] = 1 + 4 * _dn[i];
+		}
+	}
+
+	size_t size() const { return _count; }
+
+	/**
+	* Push a value.
+	*
+	* @param x Input value.
+	*/
+	void push(double x)
+	{
+		if (_count < 5)
+		{
+			_h[_count++] = x;
+			std::sort(_h, _h + _count);
+			return;
+		}
+		_count++;
+
+		int k;
+		if (x < _h[0])
+			_h[0] = x, k = 0;
+		else if (x >= _h[4])
+			_h[4] = x, k = 3;
+		else
+			for (k = 0; k < 3 && x >= _h[k + 1]; ++k) {}
+
+		for (int i = k + 1; i < 5; ++i)
+			_n[i]++;
+		for (int i = 0; i < 5; ++i)
+			_np[i] += _dn[i];
+
+		for (int i = 1; i < 4; ++i)
+		{
+			double d = _np[i] - _n[i];
+			if ((d >= 1 && _n[i + 1] - _n[i] > 1) || (d <= -1 && _n[i - 1] - _n[i] < -1))
+			{
+				int s = d > 0 ? 1 : -1;
+				double h = parabolic(i, s);
+				if (_h[i - 1] < h && h < _h[i + 1])
+					_h[i] = h;
+				else
+					_h[i] += s * (_h[i + s] - _h[i]) / (_n[i + s] - _n[i]);
+				_n[i] += s;
+			}
+		}
+	}
+
+	/**
+	* Estimated quantile, exact for less than six values.
+	*/
+	double get_quantile() const
+	{
+		if (_count == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		if (_count <= 5)
+		{
+			double h = (_count - 1) * _q;
+			size_t lo = static_cast<size_t>(h);
+			return lo + 1 < _count ? _h[lo] + (h - lo) * (_h[lo + 1] - _h[lo]) : _h[lo];
+		}
+		return _h[2];
+	}
+
+protected:
+
+	double parabolic(int i, int s) const
+	{
+		return _h[i] + s / (_n[i + 1] - _n[i - 1]) * (
+			(_n[i] - _n[i - 1] + s) * (_h[i + 1] - _h[i]) / (_n[i + 1] - _n[i])
+			+ (_n[i + 1] - _n[i] - s) * (_h[i] - _h[i - 1]) / (_n[i] - _n[i - 1])
+		);
+	}
+
+	double _q;
+	size_t _count;
+	double _h[5], _n[5], _np[5], _dn[5];
+};
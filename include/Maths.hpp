@@ -1,8 +1,17 @@
+#pragma once
+
 #include <stdexcept>
 #include <cmath>
 #include <numeric>
 #include <functional>
 #include <algorithm>
+#include <memory>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <deque>
+#include "CArrayView.hpp"
+#include "CAlignedAllocator.hpp"
 
 
 /**
@@ -83,6 +92,178 @@ namespace Maths
 		return check;
 	}
 
+	// --- Contiguous runs --- //
+
+	/**
+	* Number of values by block of a `std::deque` in the standard library in use, 1 if it is unknown.
+	*
+	* @tparam ValType The type of the values of the deque.
+	*/
+	template<typename ValType>
+	size_t deque_block_size()
+	{
+#if defined(__GLIBCXX__)
+#ifdef _GLIBCXX_DEQUE_BUF_SIZE
+		const size_t buf_size = _GLIBCXX_DEQUE_BUF_SIZE;
+#else
+		const size_t buf_size = 512;
+#endif
+		return sizeof(ValType) < buf_size ? buf_size / sizeof(ValType) : 1;
+#elif defined(_LIBCPP_VERSION)
+		return sizeof(ValType) < 256 ? 4096 / sizeof(ValType) : 16;
+#elif defined(_MSC_VER)
+		return sizeof(ValType) <= 1 ? 16 : sizeof(ValType) <= 2 ? 8 : sizeof(ValType) <= 4 ? 4 : sizeof(ValType) <= 8 ? 2 : 1;
+#else
+		return 1;
+#endif
+	}
+
+	/**
+	* Boolean checking if an iterator is an iterator of `std::deque`, whose values are stored by fixed-size blocks.
+	*/
+	template<typename It>
+	struct is_deque_iterator : std::integral_constant<bool,
+		std::is_same<It, typename std::deque<typename std::iterator_traits<It>::value_type>::iterator>::value
+		|| std::is_same<It, typename std::deque<typename std::iterator_traits<It>::value_type>::const_iterator>::value
+	> {};
+
+	/**
+	* Boolean checking if an iterator is a pointer or an iterator of `std::vector`, whose values are contiguous.
+	*/
+	template<typename It>
+	struct is_contiguous_iterator : std::integral_constant<bool,
+		std::is_pointer<It>::value || is_vector_iterator<It>::value
+	> {};
+
+	/**
+	* Length of the run of contiguous values starting at a deque iterator, at most `n`.
+	*
+	* Runs are not longer than a block, so that a run spans at most two blocks, and is contiguous
+	* if and only if its last value is at the expected address: the end of the block is found
+	* by binary search on addresses, in O(log(block size)), without walking the block.
+	*/
+	template<typename It>
+	size_t contiguous_run(It it, size_t n, std::true_type)
+	{
+		typedef typename std::iterator_traits<It>::value_type ValType;
+		n = std::min(n, Maths::deque_block_size<ValType>());
+		const ValType* p = &*it;
+		if (n <= 1 || &*(it + (n - 1)) == p + (n - 1))
+			return n;
+
+		size_t lo = 1, hi = n;
+		while (hi - lo > 1)
+		{
+			size_t mid = lo + (hi - lo) / 2;
+			if (&*(it + (mid - 1)) == p + (mid - 1))
+				lo = mid;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+
+	/**
+	* Length of the run of contiguous values starting at an iterator other than a deque iterator, at most `n`.
+	*/
+	template<typename It>
+	size_t contiguous_run(It, size_t n, std::false_type)
+	{
+		return Maths::is_contiguous_iterator<It>::value ? n : std::min<size_t>(n, 1);
+	}
+
+	template<typename InputIt, typename Func>
+	void for_each_run(InputIt first, InputIt last, Func func, std::true_type)
+	{
+		size_t left = static_cast<size_t>(last - first);
+		while (left > 0)
+		{
+			size_t n = Maths::contiguous_run(first, left, Maths::is_deque_iterator<InputIt>());
+			func(&*first, n);
+			first += n;
+			left -= n;
+		}
+	}
+
+	template<typename InputIt, typename Func>
+	void for_each_run(InputIt first, InputIt last, Func func, std::false_type)
+	{
+		for (; first != last; ++first)
+		{
+			typename std::iterator_traits<InputIt>::value_type e = *first;
+			func(&e, 1);
+		}
+	}
+
+	/**
+	* Call a function on the runs of contiguous values of a range, block by block for `std::deque`,
+	* at once for contiguous containers, and value by value otherwise,
+	* so that reductions are loops on pointers, which compilers optimize and vectorize.
+	*
+	* @tparam InputIt The type of the iterators of the range.
+	* @tparam Func The type of the function, called as `func(p, n)` with a pointer to `n` contiguous values.
+	*
+	* @param first, last Input range.
+	* @param func Function called on each run, in the order of the range.
+	*/
+	template<typename InputIt, typename Func>
+	void for_each_run(InputIt first, InputIt last, Func func)
+	{
+		Maths::for_each_run(first, last, func, std::integral_constant<bool,
+			Maths::is_deque_iterator<InputIt>::value || Maths::is_contiguous_iterator<InputIt>::value
+		>());
+	}
+
+	template<typename InputIt, typename OutputIt, typename Func>
+	OutputIt transform_runs(InputIt first, InputIt last, OutputIt out, Func func, std::true_type)
+	{
+		size_t left = static_cast<size_t>(std::distance(first, last)), n_in = 0, n_out = 0;
+		while (left > 0)
+		{
+			if (n_in == 0)
+				n_in = Maths::contiguous_run(first, left, Maths::is_deque_iterator<InputIt>());
+			if (n_out == 0)
+				n_out = Maths::contiguous_run(out, left, Maths::is_deque_iterator<OutputIt>());
+			size_t n = std::min(n_in, n_out);
+			auto p = &*first;
+			auto q = &*out;
+			for (size_t k = 0; k < n; ++k)
+				q[k] = func(p[k]);
+			std::advance(first, n);
+			std::advance(out, n);
+			n_in -= n, n_out -= n, left -= n;
+		}
+		return out;
+	}
+
+	template<typename InputIt, typename OutputIt, typename Func>
+	OutputIt transform_runs(InputIt first, InputIt last, OutputIt out, Func func, std::false_type)
+	{
+		return std::transform(first, last, out, func);
+	}
+
+	/**
+	* Element-wise transformation as `std::transform`, by runs of contiguous values when the input or
+	* the output is a `std::deque`, so that each block is transformed by a loop on pointers, which compilers vectorize.
+	*
+	* @tparam InputIt The type of the iterators of the input range.
+	* @tparam OutputIt The type of the iterators of the output range.
+	* @tparam Func The type of the unary function.
+	*
+	* @param first, last Input range.
+	* @param out Beginning of the output range.
+	* @param func Unary function.
+	*
+	* @return Iterator past the last transformed value.
+	*/
+	template<typename InputIt, typename OutputIt, typename Func>
+	OutputIt transform_runs(InputIt first, InputIt last, OutputIt out, Func func)
+	{
+		return Maths::transform_runs(first, last, out, func, std::integral_constant<bool,
+			Maths::is_deque_iterator<InputIt>::value || Maths::is_deque_iterator<OutputIt>::value
+		>());
+	}
+
 	// --- Aggregation functions --- //
 
 	/**
@@ -113,19 +294,21 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
 	* @param a Coefficient.
 	* @param b Intercept.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise linear transformation of `x`,
 	* ie `y = a * x + b`.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	ContType<double, std::allocator<double>> linear(const ContType<ValType, Alloc>& x, double a, double b)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> linear(const ContType<ValType, Alloc>& x, double a, double b, const OutAlloc& alloc = OutAlloc())
 	{
-		ContType<double, std::allocator<double>> y(x.size());
-		std::transform(x.begin(), x.end(), y.begin(), [a, b](const double& e) { return a * e + b; });
+		ContType<double, OutAlloc> y(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), y.begin(), [a, b](const double& e) { return a * e + b; });
 		return y;
 	}
 
@@ -153,20 +336,22 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise reciprocal/inverse of `x`,
 	* whose data type is double to keep the maximum of numerical precision.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> reciprocal(const ContType<ValType, Alloc>& x)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> reciprocal(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
 	{
 		if (std::find(x.begin(), x.end(), static_cast<ValType>(0)) != x.end())
 			throw std::invalid_argument("Input contains zero value(s).");
 
-		ContType<double, std::allocator<double>> x_inv(x.size());
-		std::transform(x.begin(), x.end(), x_inv.begin(), [](const ValType& e) { return 1.0 / e; });
+		ContType<double, OutAlloc> x_inv(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_inv.begin(), [](const ValType& e) { return 1.0 / e; });
 		return x_inv;
 	}
 
@@ -175,18 +360,20 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
 	* @param exp Exponent.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise power of `x` from `exp`,
 	* whose data type is double to keep the maximum of numerical precision.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> power(const ContType<ValType, Alloc>& x, double exp)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> power(const ContType<ValType, Alloc>& x, double exp, const OutAlloc& alloc = OutAlloc())
 	{
-		ContType<double, std::allocator<double>> x_pow(x.size());
-		std::transform(x.begin(), x.end(), x_pow.begin(), [exp](const double& e) { return std::pow(e, exp); });
+		ContType<double, OutAlloc> x_pow(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_pow.begin(), [exp](const double& e) { return std::pow(e, exp); });
 		return x_pow;
 	}
 
@@ -195,20 +382,22 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise logarithm of `x`,
 	* whose data type is double to keep the maximum of numerical precision.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> log(const ContType<ValType, Alloc>& x)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> log(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
 	{
 		if (!Maths::is_positive(x))
 			throw std::invalid_argument("Input contains negative value(s).");
 
-		ContType<double, std::allocator<double>> x_log(x.size());
-		std::transform(x.begin(), x.end(), x_log.begin(), [](const ValType& e) { return std::log(e); });
+		ContType<double, OutAlloc> x_log(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_log.begin(), [](const ValType& e) { return std::log(e); });
 		return x_log;
 	}
 
@@ -217,17 +406,19 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise exponential of `x`,
 	* whose data type is double to keep the maximum of numerical precision.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> exp(const ContType<ValType, Alloc>& x)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> exp(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
 	{
-		ContType<double, std::allocator<double>> x_exp(x.size());
-		std::transform(x.begin(), x.end(), x_exp.begin(), [](const ValType& e) { return std::exp(e); });
+		ContType<double, OutAlloc> x_exp(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_exp.begin(), [](const ValType& e) { return std::exp(e); });
 		return x_exp;
 	}
 
@@ -236,22 +427,109 @@ namespace Maths
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
 	* @return Output sequence container containing the element-wise sigmoid of `x`,
 	* whose data type is double to keep the maximum of numerical precision.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> sigmoid(const ContType<ValType, Alloc>& x)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> sigmoid(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
 	{
-		ContType<double, std::allocator<double>> x_sig(x.size());
-		std::transform(x.begin(), x.end(), x_sig.begin(), [](const ValType& e) { return 1.0 / (1.0 + std::exp(-e)); });
+		ContType<double, OutAlloc> x_sig(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_sig.begin(), [](const ValType& e) { return 1.0 / (1.0 + std::exp(-e)); });
 		return x_sig;
 	}
 
 	// --- Others --- //
 
+	/**
+	* Allocator of doubles rebound from the allocator of an input sequence container,
+	* so that temporaries of functions are allocated like their input, for instance in an `Arena`.
+	*
+	* @tparam Alloc The allocator of the input sequence container.
+	*/
+	template<typename Alloc>
+	using DoubleAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<double>;
+
+	/**
+	* Allocator of doubles for the temporaries of any sequence container: `DoubleAlloc` of its allocator
+	* if it has one, `std::allocator<double>` otherwise, like for `std::array`.
+	*
+	* @tparam ContType The type of the sequence container.
+	*/
+	template<typename ContType, typename = void>
+	struct ScratchAllocTraits
+	{
+		typedef std::allocator<double> type;
+		static type get(const ContType&) { return type(); }
+	};
+
+	template<typename ContType>
+	struct ScratchAllocTraits<ContType, typename std::conditional<true, void, typename ContType::allocator_type>::type>
+	{
+		typedef DoubleAlloc<typename ContType::allocator_type> type;
+		static type get(const ContType& x) { return type(x.get_allocator()); }
+	};
+
+	template<typename ContType>
+	using ScratchAlloc = typename ScratchAllocTraits<ContType>::type;
+
+	/**
+	* Allocator of doubles for the temporaries of a sequence container, see `ScratchAllocTraits`.
+	*/
+	template<typename ContType>
+	ScratchAlloc<ContType> scratch_allocator(const ContType& x)
+	{
+		return ScratchAllocTraits<ContType>::get(x);
+	}
+
+	/**
+	* Allocator of buffers aligned on cache lines of 64 bytes, allocating their memory with an input allocator.
+	*
+	* @tparam Alloc The allocator of the input sequence container.
+	*/
+	template<typename Alloc>
+	using CacheAlignedAlloc = AlignedAllocator<typename std::allocator_traits<Alloc>::value_type, Alloc, 64>;
+
+	/**
+	* Contiguous version of a sequence container, for scratch computations:
+	* a copy in a contiguous buffer aligned on cache lines for non-contiguous containers,
+	* like `std::list` and `std::deque`, so that temporaries computed from it are contiguous too.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	*
+	* @param x Input sequence container.
+	*
+	* @return Read-only contiguous view of the values of `x`, whose iterators are pointers.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
+	ArrayView<const ValType, CacheAlignedAlloc<Alloc>> contiguous(const ContType<ValType, Alloc>& x)
+	{
+		return ArrayView<const ValType, CacheAlignedAlloc<Alloc>>(x.begin(), x.end(), CacheAlignedAlloc<Alloc>(x.get_allocator()));
+	}
+
+	/**
+	* Contiguous version of a vector: a read-only view without copy.
+	*/
+	template<typename ValType, typename Alloc>
+	ArrayView<const ValType, Alloc> contiguous(const std::vector<ValType, Alloc>& x)
+	{
+		return ArrayView<const ValType, Alloc>(x);
+	}
+
+	/**
+	* Contiguous version of a contiguous view: a read-only view of the same values, without copy.
+	*/
+	template<typename ValType, typename Alloc>
+	ArrayView<const ValType, Alloc> contiguous(const ArrayView<ValType, Alloc>& x)
+	{
+		return ArrayView<const ValType, Alloc>(x.data(), x.size());
+	}
+
 	/**
 	* Set of the container.
 	*
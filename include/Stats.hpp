@@ -1,3 +1,5 @@
+#pragma once
+
 #include <stdexcept>
 #include <limits>
 #include <numeric>
@@ -5,7 +7,13 @@
 #include <functional>
 #include <algorithm>
 #include <vector>
+#include <queue>
+#include <iterator>
+#include <thread>
 #include "Maths.hpp"
+#include "CExponentialMovingStats.hpp"
+#include "CRunningMoments.hpp"
+#include "CMatrixView.hpp"
 
 
 /**
@@ -31,7 +39,13 @@ namespace Stats
 		if (size == 0)
 			throw std::invalid_argument("Input has not enough values for mean.");
 
-		double sx = std::accumulate(x.begin(), x.end(), 0.0);
+		double sx = 0;
+		Maths::for_each_run(x.begin(), x.end(), [&sx](const typename ContType::value_type* p, size_t n) {
+			double s = sx;
+			for (size_t k = 0; k < n; ++k)
+				s += p[k];
+			sx = s;
+		});
 		return sx / size;
 	}
 
@@ -52,7 +66,8 @@ namespace Stats
 		if (size == 0)
 			throw std::invalid_argument("Input has not enough values for hmean.");
 
-		ContType<double, std::allocator<double>> x_inv = Maths::reciprocal(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_inv = Maths::reciprocal(Maths::contiguous(x), alloc);
 		double sxinv = std::accumulate(x_inv.begin(), x_inv.end(), 0.0);
 		return size / sxinv;
 	}
@@ -98,7 +113,8 @@ namespace Stats
 		if (!Maths::is_positive(x))
 			throw std::invalid_argument("Input contains negative value(s).");
 
-		ContType<double, std::allocator<double>> x_pow = Maths::power(x, exp);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_pow = Maths::power(Maths::contiguous(x), exp, alloc);
 		double sxpow = std::accumulate(x_pow.begin(), x_pow.end(), 0.0);
 		return std::pow(sxpow / size, 1.0 / exp);
 	}
@@ -123,7 +139,8 @@ namespace Stats
 		if (size - ddof == 0)
 			throw std::invalid_argument("Size minus degree of freedom is 0.");
 
-		ContType<double, std::allocator<double>> x_cent = Stats::center(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent = Stats::center(Maths::contiguous(x), alloc);
 		double sxx = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
 		return sxx / (size - ddof);
 	}
@@ -158,7 +175,8 @@ namespace Stats
 	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
 	double hstd(const ContType<ValType, Alloc>& x, size_t ddof = 0)
 	{
-		ContType<double, std::allocator<double>> x_inv = Maths::reciprocal(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_inv = Maths::reciprocal(Maths::contiguous(x), alloc);
 		return 1.0 / Stats::std(x_inv, ddof);
 	}
 
@@ -176,7 +194,8 @@ namespace Stats
 	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
 	double gstd(const ContType<ValType, Alloc>& x, size_t ddof = 0)
 	{
-		ContType<double, std::allocator<double>> x_log = Maths::log(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_log = Maths::log(Maths::contiguous(x), alloc);
 		return std::exp(Stats::std(x_log, ddof));
 	}
 
@@ -197,10 +216,11 @@ namespace Stats
 		if (size <= 1)
 			throw std::invalid_argument("Input has not enough values for skewness.");
 
-		ContType<double, std::allocator<double>> x_cent = Stats::center(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent = Stats::center(Maths::contiguous(x), alloc);
 		double sx2 = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
 
-		ContType<double, std::allocator<double>> x_cent_3 = Maths::pow(x_cent, 3.0);
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent_3 = Maths::power(x_cent, 3.0, alloc);
 		double sx3 = std::accumulate(x_cent_3.begin(), x_cent_3.end(), 0.0);
 
 		double skew = (sx3 * std::pow(size, 0.5)) / std::pow(sx2, 1.5);
@@ -224,10 +244,11 @@ namespace Stats
 		if (size <= 1)
 			throw std::invalid_argument("Input has not enough values for kurtosis.");
 
-		ContType<double, std::allocator<double>> x_cent = Stats::center(x);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent = Stats::center(Maths::contiguous(x), alloc);
 		double sx2 = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
 
-		ContType<double, std::allocator<double>> x_cent_4 = Maths::pow(x_cent, 4.0);
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent_4 = Maths::power(x_cent, 4.0, alloc);
 		double sx4 = std::accumulate(x_cent_4.begin(), x_cent_4.end(), 0.0);
 
 		double kurt = (sx4 * size) / (sx2 * sx2);
@@ -252,7 +273,9 @@ namespace Stats
 		if (size == 0)
 			throw std::invalid_argument("Input has not enough values for median.");
 
-		std::vector<typename ContType::value_type> x_sort(x.begin(), x.end());
+		typedef typename std::remove_const<typename ContType::value_type>::type KeyType;
+		typedef typename std::allocator_traits<Maths::ScratchAlloc<ContType>>::template rebind_alloc<KeyType> KeyAlloc;
+		std::vector<KeyType, KeyAlloc> x_sort(x.begin(), x.end(), Maths::scratch_allocator(x));
 		std::sort(x_sort.begin(), x_sort.end());
 
 		double med;
@@ -280,9 +303,8 @@ namespace Stats
 	{
 		double med = Stats::median(x);
 
-		ContType<double, std::allocator<double>> x_cent(x.size());
-		std::transform(x.begin(), x.end(), x_cent.begin(), std::bind2nd(std::minus<double>(), med));
-		ContType<double, std::allocator<double>> x_cent_abs = Maths::absolute(x_cent);
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent_abs(x.size(), 0.0, Maths::DoubleAlloc<Alloc>(x.get_allocator()));
+		std::transform(x.begin(), x.end(), x_cent_abs.begin(), [med](const ValType& e) { return std::fabs(e - med); });
 
 		double mad = Stats::median(x_cent_abs);
 		if (is_rescaled)
@@ -290,77 +312,1901 @@ namespace Stats
 		return mad;
 	}
 
-	// --- Transformations --- //
+	/**
+	* Interpolation methods of `quantiles`, when a quantile lies between two values `i < j`.
+	*/
+	enum QuantileMethod
+	{
+		QUANTILE_LINEAR, //!< i + (j - i) * fraction
+		QUANTILE_LOWER, //!< i
+		QUANTILE_HIGHER, //!< j
+		QUANTILE_NEAREST, //!< i or j, whichever is nearest, rounding half to even
+		QUANTILE_MIDPOINT //!< (i + j) / 2
+	};
 
 	/**
-	* Center values with respect their mean.
+	* Recursive multi-selection: place the values of ranks `[r_first, r_last)`, sorted and distinct,
+	* at their sorted positions in `x`, partitioning only `[first, last)`.
+	*/
+	template<typename SAlloc>
+	void select_ranks(
+		std::vector<double, SAlloc>& x, size_t first, size_t last, const size_t* r_first, const size_t* r_last
+	)
+	{
+		while (r_first != r_last)
+		{
+			const size_t* r_mid = r_first + (r_last - r_first) / 2;
+			std::nth_element(x.begin() + first, x.begin() + *r_mid, x.begin() + last);
+			Stats::select_ranks(x, first, *r_mid, r_first, r_mid);
+			first = *r_mid + 1;
+			r_first = r_mid + 1;
+		}
+	}
+
+	/**
+	* Quantiles of a scratch buffer, partially sorting it by one multi-selection.
+	*
+	* @tparam SAlloc The allocator of the scratch buffer, also allocating the output.
+	*
+	* @param x Scratch buffer, not empty, whose order is modified.
+	* @param qs Quantiles, in [0, 1].
+	* @param method Interpolation method.
+	*
+	* @return Quantiles of `x`, in the order of `qs`.
+	*/
+	template<typename SAlloc>
+	std::vector<double, SAlloc> select_quantiles(
+		std::vector<double, SAlloc>& x, const std::vector<double>& qs, QuantileMethod method = QUANTILE_LINEAR
+	)
+	{
+		size_t size = x.size();
+		std::vector<size_t, typename std::allocator_traits<SAlloc>::template rebind_alloc<size_t>> ranks(x.get_allocator());
+		ranks.reserve(2 * qs.size());
+		for (double q : qs)
+		{
+			double h = (size - 1) * q;
+			size_t lo = static_cast<size_t>(h);
+			ranks.push_back(lo);
+			if (h != lo)
+				ranks.push_back(lo + 1);
+		}
+		std::sort(ranks.begin(), ranks.end());
+		ranks.erase(std::unique(ranks.begin(), ranks.end()), ranks.end());
+		Stats::select_ranks(x, 0, size, ranks.data(), ranks.data() + ranks.size());
+
+		std::vector<double, SAlloc> x_q(qs.size(), 0.0, x.get_allocator());
+		std::transform(qs.begin(), qs.end(), x_q.begin(), [&x, size, method](double q) {
+			double h = (size - 1) * q;
+			size_t lo = static_cast<size_t>(h);
+			double frac = h - lo;
+			if (frac == 0)
+				return x[lo];
+
+			switch (method)
+			{
+			case QUANTILE_LOWER:
+				return x[lo];
+			case QUANTILE_HIGHER:
+				return x[lo + 1];
+			case QUANTILE_NEAREST:
+				return x[static_cast<size_t>(std::nearbyint(h))];
+			case QUANTILE_MIDPOINT:
+				return (x[lo] + x[lo + 1]) / 2;
+			default:
+				return x[lo] + frac * (x[lo + 1] - x[lo]);
+			}
+		});
+		return x_q;
+	}
+
+	/**
+	* Quantiles, computed by one recursive multi-selection on a single scratch copy.
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam QContType The type of the sequence container of quantiles.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
+	* @param qs Input sequence container containing quantiles, in [0, 1].
+	* @param method Interpolation method, with the same definitions as
+	* the methods of `numpy.quantile` of the same names.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
-	* @return Output sequence container containing the centered version of `x`,
-	* whose data type is double to keep the maximum of numerical precision.
+	* @return Output sequence container containing the quantiles of `x`, in the order of `qs`.
+	*
+	* @see [numpy.quantile](https://numpy.org/doc/stable/reference/generated/numpy.quantile.html)
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> center(const ContType<ValType, Alloc>& x)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename QContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> quantiles(
+		const ContType<ValType, Alloc>& x, const QContType& qs, QuantileMethod method = QUANTILE_LINEAR,
+		const OutAlloc& alloc = OutAlloc()
+	)
 	{
-		double mean = Stats::mean(x);
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for quantiles.");
+		if (std::any_of(qs.begin(), qs.end(), [](double q) { return !(q >= 0 && q <= 1); }))
+			throw std::invalid_argument("Quantiles must be in [0, 1].");
 
-		ContType<double, std::allocator<double>> x_cent(x.size());
-		std::transform(x.begin(), x.end(), x_cent.begin(), std::bind2nd(std::minus<double>(), mean));
-		return x_cent;
+		std::vector<double, Maths::DoubleAlloc<Alloc>> x_sel(x.begin(), x.end(), Maths::DoubleAlloc<Alloc>(x.get_allocator()));
+		std::vector<double, Maths::DoubleAlloc<Alloc>> x_q =
+			Stats::select_quantiles(x_sel, std::vector<double>(qs.begin(), qs.end()), method);
+		return ContType<double, OutAlloc>(x_q.begin(), x_q.end(), alloc);
 	}
 
+	// --- Robust summary statistics --- //
+
 	/**
-	* Standard score (z-score).
+	* Tails of values returned by `tail_summary`.
+	*/
+	struct TailSummary
+	{
+		size_t count; //!< number of values
+		double sum; //!< sum of values
+		double low_cutoff, high_cutoff; //!< order statistics of ranks `n_low` and `count - 1 - n_high`
+		double low_sum, high_sum; //!< sums of the `n_low` smallest and `n_high` largest values
+	};
+
+	/**
+	* Summary of the tails of values, in one pass and without copying values.
+	*
+	* The `n_low + 1` smallest and `n_high + 1` largest values are kept in bounded heaps,
+	* so memory is proportional to the tails and not to the number of values:
+	* this is suited to small trimming proportions and to single-pass input iterators.
+	*
+	* @tparam InputIt The type of the input iterators.
+	*
+	* @param first, last Range of values, containing more than `n_low + n_high` values.
+	* @param n_low, n_high Number of smallest and largest values in the tails.
+	*
+	* @return Count, sum, cutoffs and sums of the tails.
+	*/
+	template<typename InputIt>
+	TailSummary tail_summary(InputIt first, InputIt last, size_t n_low, size_t n_high)
+	{
+		std::priority_queue<double> low;
+		std::priority_queue<double, std::vector<double>, std::greater<double>> high;
+		TailSummary tails = { 0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+		for (; first != last; ++first)
+		{
+			double v = static_cast<double>(*first);
+			tails.count++;
+			tails.sum += v;
+			if (low.size() <= n_low)
+				low.push(v);
+			else if (v < low.top())
+				low.pop(), low.push(v);
+			if (high.size() <= n_high)
+				high.push(v);
+			else if (v > high.top())
+				high.pop(), high.push(v);
+		}
+		if (tails.count <= n_low + n_high)
+			throw std::invalid_argument("Input has not enough values for tail_summary.");
+
+		tails.low_cutoff = low.top();
+		tails.high_cutoff = high.top();
+		for (low.pop(); !low.empty(); low.pop())
+			tails.low_sum += low.top();
+		for (high.pop(); !high.empty(); high.pop())
+			tails.high_sum += high.top();
+		return tails;
+	}
+
+	/**
+	* Cutoffs of tails, ie order statistics of ranks `n_low` and `size - 1 - n_high`,
+	* by `tail_summary` for small tails, and by selection on a scratch copy otherwise.
+	*/
+	template<typename ContType>
+	std::pair<double, double> tail_cutoffs(const ContType& x, size_t n_low, size_t n_high)
+	{
+		size_t size = x.size();
+		if (8 * (n_low + n_high + 2) <= size)
+		{
+			TailSummary tails = Stats::tail_summary(x.begin(), x.end(), n_low, n_high);
+			return std::make_pair(tails.low_cutoff, tails.high_cutoff);
+		}
+
+		std::vector<double, Maths::ScratchAlloc<ContType>> x_sel(x.begin(), x.end(), Maths::scratch_allocator(x));
+		size_t ranks[2] = { n_low, size - 1 - n_high };
+		Stats::select_ranks(x_sel, 0, size, ranks, ranks + (ranks[0] == ranks[1] ? 1 : 2));
+		return std::make_pair(x_sel[ranks[0]], x_sel[ranks[1]]);
+	}
+
+	/**
+	* Trimmed mean, cutting a proportion of smallest and largest values.
+	*
+	* Cutoffs are located by `tail_cutoffs`, then only kept values are summed in one pass,
+	* ie values strictly between cutoffs and the kept number of values tied with cutoffs,
+	* so that huge cut values do not cancel the sum of kept values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param proportiontocut Proportion of values cut from each end, in [0, 0.5).
+	*
+	* @return Mean of `x`, without the `floor(proportiontocut * size)` smallest and largest values.
+	*
+	* @see [scipy.stats.trim_mean](https://docs.scipy.org/doc/scipy/reference/generated/scipy.stats.trim_mean.html)
+	*/
+	template<typename ContType>
+	double trim_mean(const ContType& x, double proportiontocut)
+	{
+		size_t size = x.size();
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for trim_mean.");
+		if (!(proportiontocut >= 0 && proportiontocut < 0.5))
+			throw std::invalid_argument("Proportion to cut must be in [0, 0.5).");
+
+		size_t n_cut = static_cast<size_t>(proportiontocut * size);
+		if (2 * n_cut >= size)
+			throw std::invalid_argument("Proportion to cut is too big.");
+
+		std::pair<double, double> cutoffs = Stats::tail_cutoffs(x, n_cut, n_cut);
+		double lo = cutoffs.first, hi = cutoffs.second;
+		size_t n_kept = size - 2 * n_cut;
+		if (lo == hi)
+			return lo;
+
+		size_t n_below = 0, n_lo = 0, n_between = 0;
+		double sx = 0;
+		for (const auto& e : x)
+		{
+			double v = static_cast<double>(e);
+			if (v < lo)
+				n_below++;
+			else if (v == lo)
+				n_lo++;
+			else if (v < hi)
+			{
+				n_between++;
+				sx += v;
+			}
+		}
+		size_t n_lo_kept = n_below + n_lo - n_cut;
+		size_t n_hi_kept = n_kept - n_between - n_lo_kept;
+		return (sx + n_lo_kept * lo + n_hi_kept * hi) / n_kept;
+	}
+
+	/**
+	* Cutoffs of winsorization, ie order statistics of ranks `floor(limit_low * size)`
+	* and `size - 1 - floor(limit_high * size)`.
+	*/
+	template<typename ContType>
+	std::pair<double, double> winsorize_cutoffs(const ContType& x, double limit_low, double limit_high)
+	{
+		size_t size = x.size();
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for winsorize.");
+		if (!(limit_low >= 0 && limit_high >= 0 && limit_low + limit_high < 1))
+			throw std::invalid_argument("Limits must be positive, with a sum lower than 1.");
+
+		size_t n_low = static_cast<size_t>(limit_low * size), n_high = static_cast<size_t>(limit_high * size);
+		if (n_low + n_high >= size)
+			throw std::invalid_argument("Limits are too big.");
+
+		return Stats::tail_cutoffs(x, n_low, n_high);
+	}
+
+	/**
+	* Winsorization, replacing the smallest and largest values by cutoff values.
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
 	*
 	* @param x Input sequence container.
-	* @param ddof Degree of freedom.
+	* @param limit_low Proportion of smallest values to replace.
+	* @param limit_high Proportion of largest values to replace.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
-	* @return Output sequence container containing the z-scores of `x`,
+	* @return Output sequence container containing the winsorized version of `x`,
 	* whose data type is double to keep the maximum of numerical precision.
+	*
+	* @see [scipy.stats.mstats.winsorize](https://docs.scipy.org/doc/scipy/reference/generated/scipy.stats.mstats.winsorize.html)
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> zscore(const ContType<ValType, Alloc>& x, size_t ddof = 0)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> winsorize(
+		const ContType<ValType, Alloc>& x, double limit_low, double limit_high, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		std::pair<double, double> cutoffs = Stats::winsorize_cutoffs(x, limit_low, limit_high);
+		double lo = cutoffs.first, hi = cutoffs.second;
+
+		ContType<double, OutAlloc> x_win(x.size(), 0.0, alloc);
+		std::transform(x.begin(), x.end(), x_win.begin(), [lo, hi](const ValType& e) {
+			return std::min(std::max(static_cast<double>(e), lo), hi);
+		});
+		return x_win;
+	}
+
+	/**
+	* Winsorized variance, from one fused pass on winsorized values, without copying values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param limit_low Proportion of smallest values to replace.
+	* @param limit_high Proportion of largest values to replace.
+	* @param ddof Degree of freedom.
+	*
+	* @return Variance of the winsorized version of `x`.
+	*/
+	template<typename ContType>
+	double winsorized_var(const ContType& x, double limit_low, double limit_high, size_t ddof = 0)
 	{
 		size_t size = x.size();
 		if (size <= 1)
-			throw std::invalid_argument("Input has not enough values for zscore.");
+			throw std::invalid_argument("Input has not enough values for winsorized_var.");
 		if (size - ddof == 0)
 			throw std::invalid_argument("Size minus degree of freedom is 0.");
 
-		ContType<double, std::allocator<double>> x_cent = Stats::center(x);
-		double sxx = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
-		double std = std::sqrt(sxx / (size - ddof));
+		std::pair<double, double> cutoffs = Stats::winsorize_cutoffs(x, limit_low, limit_high);
+		RunningMoments moments;
+		for (const auto& e : x)
+			moments.push(std::min(std::max(static_cast<double>(e), cutoffs.first), cutoffs.second));
+		return moments.get_var(ddof);
+	}
 
-		ContType<double, std::allocator<double>> z(size);
-		std::transform(x_cent.begin(), x_cent.end(), z.begin(), std::bind2nd(std::divides<double>(), std));
-		return z;
+	/**
+	* Winsorized standard deviation.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param limit_low Proportion of smallest values to replace.
+	* @param limit_high Proportion of largest values to replace.
+	* @param ddof Degree of freedom.
+	*
+	* @return Standard deviation of the winsorized version of `x`.
+	*/
+	template<typename ContType>
+	double winsorized_std(const ContType& x, double limit_low, double limit_high, size_t ddof = 0)
+	{
+		return std::sqrt(Stats::winsorized_var(x, limit_low, limit_high, ddof));
 	}
 
+	// --- Weighted summary statistics --- //
+
 	/**
-	* Geometric standard score (geometric z-score).
+	* Weighted sums returned by `weighted_moments`.
+	*/
+	struct WeightedMoments
+	{
+		double sw; //!< sum of weights
+		double mx, my; //!< weighted means
+		double sxx, syy, sxy; //!< weighted sums of products of deviations from the means
+	};
+
+	/**
+	* Weighted means and sums of products of deviations, in one fused pass,
+	* using the weighted incremental algorithm of West.
+	*/
+	template<typename XIt, typename YIt, typename WIt>
+	WeightedMoments weighted_moments(XIt x_it, XIt x_last, YIt y_it, WIt w_it)
+	{
+		WeightedMoments wm = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+		for (; x_it != x_last; ++x_it, ++y_it, ++w_it)
+		{
+			double w = static_cast<double>(*w_it);
+			if (!(w >= 0))
+				throw std::invalid_argument("Weights must be positive.");
+			if (w == 0)
+				continue;
+
+			double x = static_cast<double>(*x_it), y = static_cast<double>(*y_it);
+			wm.sw += w;
+			double dx = x - wm.mx, dy = y - wm.my;
+			wm.mx += dx * w / wm.sw;
+			wm.my += dy * w / wm.sw;
+			wm.sxx += w * dx * (x - wm.mx);
+			wm.syy += w * dy * (y - wm.my);
+			wm.sxy += w * dx * (y - wm.my);
+		}
+		if (wm.sw <= 0)
+			throw std::invalid_argument("Sum of weights must be positive.");
+		return wm;
+	}
+
+	/**
+	* Weighted mean.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam WContType The type of the sequence container of weights.
+	*
+	* @param x Input sequence container.
+	* @param w Input sequence container containing positive weights of values, like counts.
+	*
+	* @return Weighted arithmetic mean of `x`.
+	*/
+	template<typename ContType, typename WContType>
+	double weighted_mean(const ContType& x, const WContType& w)
+	{
+		size_t size = x.size();
+		if (size != w.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for weighted_mean.");
+
+		return Stats::weighted_moments(x.begin(), x.end(), x.begin(), w.begin()).mx;
+	}
+
+	/**
+	* Weighted variance, with frequency weights.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam WContType The type of the sequence container of weights.
+	*
+	* @param x Input sequence container.
+	* @param w Input sequence container containing positive weights of values, like counts.
+	* @param ddof Degree of freedom, subtracted from the sum of weights.
+	*
+	* @return Weighted variance of `x`, equal to the variance of values repeated according to integer weights.
+	*/
+	template<typename ContType, typename WContType>
+	double weighted_var(const ContType& x, const WContType& w, size_t ddof = 0)
+	{
+		size_t size = x.size();
+		if (size != w.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for weighted_var.");
+
+		WeightedMoments wm = Stats::weighted_moments(x.begin(), x.end(), x.begin(), w.begin());
+		if (wm.sw - ddof <= 0)
+			throw std::invalid_argument("Sum of weights minus degree of freedom is not positive.");
+		return wm.sxx / (wm.sw - ddof);
+	}
+
+	/**
+	* Weighted standard deviation, with frequency weights.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam WContType The type of the sequence container of weights.
+	*
+	* @param x Input sequence container.
+	* @param w Input sequence container containing positive weights of values, like counts.
+	* @param ddof Degree of freedom, subtracted from the sum of weights.
+	*
+	* @return Weighted standard deviation of `x`.
+	*/
+	template<typename ContType, typename WContType>
+	double weighted_std(const ContType& x, const WContType& w, size_t ddof = 0)
+	{
+		return std::sqrt(Stats::weighted_var(x, w, ddof));
+	}
+
+	/**
+	* Recursive weighted multi-selection: value of each weighted rank of `[r_first, r_last)`, sorted,
+	* where a value of weight `w` occupies `w` consecutive ranks, written in `v_first`.
+	* Ranks are searched in `[first, last)`, whose first rank is `base`,
+	* ranks beyond the weights of the range, from rounding, taking its greatest value.
+	*
+	* @return Pointer past the last written value.
+	*/
+	template<typename PAlloc>
+	double* weighted_select_ranks(
+		std::vector<std::pair<double, double>, PAlloc>& xw, size_t first, size_t last, double base,
+		const double* r_first, const double* r_last, double* v_first
+	)
+	{
+		bool has_greatest = false;
+		double greatest = 0;
+		while (r_first != r_last && first < last)
+		{
+			if (last - first == 1)
+			{
+				std::fill(v_first, v_first + (r_last - r_first), xw[first].first);
+				return v_first + (r_last - r_first);
+			}
+
+			size_t mid = first + (last - first) / 2;
+			std::nth_element(xw.begin() + first, xw.begin() + mid, xw.begin() + last,
+				[](const std::pair<double, double>& a, const std::pair<double, double>& b) { return a.first < b.first; });
+			double w_left = 0;
+			for (size_t i = first; i < mid; ++i)
+				w_left += xw[i].second;
+
+			const double* r_mid = std::lower_bound(r_first, r_last, base + w_left);
+			double* v_mid = Stats::weighted_select_ranks(xw, first, mid, base, r_first, r_mid, v_first);
+			v_first += r_mid - r_first;
+			std::fill(v_mid, v_first, xw[mid].first);
+
+			const double* r_right = std::lower_bound(r_mid, r_last, base + w_left + xw[mid].second);
+			std::fill(v_first, v_first + (r_right - r_mid), xw[mid].first);
+			v_first += r_right - r_mid;
+
+			first = mid + 1, base += w_left + xw[mid].second, r_first = r_right;
+			has_greatest = true, greatest = xw[mid].first;
+		}
+		if (r_first != r_last && has_greatest)
+		{
+			std::fill(v_first, v_first + (r_last - r_first), greatest);
+			v_first += r_last - r_first;
+		}
+		return v_first;
+	}
+
+	/**
+	* Weighted quantiles, with frequency weights, computed by one weighted multi-selection.
 	*
 	* @tparam ContType The type of the sequence container.
 	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam WContType The type of the sequence container of weights.
+	* @tparam QContType The type of the sequence container of quantiles.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param w Input sequence container containing positive weights of values, like counts.
+	* @param qs Input sequence container containing quantiles, in [0, 1].
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the weighted quantiles of `x`, in the order of `qs`,
+	* equal to the linearly interpolated quantiles of values repeated according to integer weights.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename WContType, typename QContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> weighted_quantiles(
+		const ContType<ValType, Alloc>& x, const WContType& w, const QContType& qs, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		size_t size = x.size();
+		if (size != w.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for weighted_quantiles.");
+		if (std::any_of(qs.begin(), qs.end(), [](double q) { return !(q >= 0 && q <= 1); }))
+			throw std::invalid_argument("Quantiles must be in [0, 1].");
+
+		typedef typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<double, double>> PairAlloc;
+		Maths::DoubleAlloc<Alloc> d_alloc(x.get_allocator());
+		std::vector<std::pair<double, double>, PairAlloc> xw(d_alloc);
+		xw.reserve(size);
+		double sw = 0;
+		auto w_it = w.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++w_it)
+		{
+			double we = static_cast<double>(*w_it);
+			if (!(we >= 0))
+				throw std::invalid_argument("Weights must be positive.");
+			if (we > 0)
+				xw.push_back(std::make_pair(static_cast<double>(*x_it), we)), sw += we;
+		}
+		if (sw <= 0)
+			throw std::invalid_argument("Sum of weights must be positive.");
+
+		std::vector<double, Maths::DoubleAlloc<Alloc>> ranks(d_alloc);
+		for (double q : qs)
+		{
+			double h = std::max(sw - 1, 0.0) * q;
+			ranks.push_back(std::floor(h));
+			ranks.push_back(std::floor(h) + 1);
+		}
+		std::vector<double, Maths::DoubleAlloc<Alloc>> r_sort(ranks);
+		std::sort(r_sort.begin(), r_sort.end());
+		r_sort.erase(std::unique(r_sort.begin(), r_sort.end()), r_sort.end());
+		std::vector<double, Maths::DoubleAlloc<Alloc>> v_sort(r_sort.size(), 0.0, d_alloc);
+		double* v_end = Stats::weighted_select_ranks(
+			xw, 0, xw.size(), 0.0, r_sort.data(), r_sort.data() + r_sort.size(), v_sort.data()
+		);
+		// ranks beyond the sum of weights, from rounding, take the greatest value
+		std::fill(v_end, v_sort.data() + v_sort.size(), std::max_element(xw.begin(), xw.end())->first);
+
+		std::vector<double, Maths::DoubleAlloc<Alloc>> x_q(d_alloc);
+		size_t i = 0;
+		for (double q : qs)
+		{
+			double h = std::max(sw - 1, 0.0) * q;
+			double x_lo = v_sort[std::lower_bound(r_sort.begin(), r_sort.end(), ranks[2 * i]) - r_sort.begin()];
+			double x_hi = v_sort[std::lower_bound(r_sort.begin(), r_sort.end(), ranks[2 * i + 1]) - r_sort.begin()];
+			x_q.push_back(x_lo + (h - std::floor(h)) * (x_hi - x_lo));
+			++i;
+		}
+		return ContType<double, OutAlloc>(x_q.begin(), x_q.end(), alloc);
+	}
+
+	/**
+	* Weighted median, with frequency weights.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam WContType The type of the sequence container of weights.
 	*
 	* @param x Input sequence container.
+	* @param w Input sequence container containing positive weights of values, like counts.
+	*
+	* @return Weighted median of `x`, equal to the median of values repeated according to integer weights.
+	*/
+	template<typename ContType, typename WContType>
+	double weighted_median(const ContType& x, const WContType& w)
+	{
+		return Stats::weighted_quantiles(x, w, std::vector<double>(1, 0.5)).front();
+	}
+
+	/**
+	* Weighted Pearson product-moment correlation coefficient, in one fused pass.
+	*
+	* @tparam ContType The type of the sequence containers.
+	* @tparam WContType The type of the sequence container of weights.
+	*
+	* @param x, y Input sequence containers.
+	* @param w Input sequence container containing positive weights of pairs of values, like counts.
+	*
+	* @return Weighted Pearson product-moment correlation coefficient of `x` and `y`.
+	*/
+	template<typename ContType, typename WContType>
+	double weighted_pearsonr(const ContType& x, const ContType& y, const WContType& w)
+	{
+		size_t size = x.size();
+		if (size != y.size() || size != w.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Inputs have not enough values for weighted_pearsonr.");
+
+		WeightedMoments wm = Stats::weighted_moments(x.begin(), x.end(), y.begin(), w.begin());
+		if (wm.sxx <= 0 || wm.syy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double r = wm.sxy / (std::sqrt(wm.sxx) * std::sqrt(wm.syy));
+		return std::max(std::min(r, 1.0), -1.0);
+	}
+
+	// --- Segmented reductions --- //
+
+	/**
+	* Offsets of segments of consecutive equal keys.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param keys Input sequence container containing keys, equal keys being consecutive.
+	*
+	* @return Output vector containing the `n_segments + 1` offsets of segments,
+	* from 0 to the size of `keys`.
+	*/
+	template<typename ContType>
+	std::vector<size_t> segment_offsets(const ContType& keys)
+	{
+		std::vector<size_t> offsets(1, 0);
+		size_t i = 0;
+		auto k_prev = keys.begin();
+		for (auto k_it = keys.begin(); k_it != keys.end(); ++k_it, ++i)
+			if (i > 0 && !(*k_it == *k_prev++))
+				offsets.push_back(i);
+		if (i > 0)
+			offsets.push_back(i);
+		return offsets;
+	}
+
+	/**
+	* Apply a function on each segment `[offsets[s], offsets[s + 1])` of a range,
+	* consecutive segments being dispatched in blocks to threads.
+	* Each block has a scratch buffer, empty until the function uses it, reused by its segments and freed at the end.
+	*
+	* @param x_first Iterator to the first value.
+	* @param offsets Offsets of segments.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the scratch buffers.
+	* @param func Function called with the index of a segment, the iterators to its first and last values,
+	* and the scratch buffer of its block.
+	*/
+	template<typename InputIt, typename SAlloc, typename Func>
+	void segmented_for_each(
+		InputIt x_first, const std::vector<size_t>& offsets, unsigned int n_threads, const SAlloc& alloc, Func func
+	)
+	{
+		size_t n_segments = offsets.size() - 1, size = offsets.back();
+		const size_t min_chunk = 1 << 16;
+		if (n_threads == 0)
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		size_t n_blocks = std::max<size_t>(1, std::min<size_t>({ n_threads, size / min_chunk, n_segments }));
+
+		auto run_block = [&offsets, &alloc, &func](InputIt it, size_t s_first, size_t s_last) {
+			std::vector<double, SAlloc> scratch(alloc);
+			for (size_t s = s_first; s < s_last; ++s)
+			{
+				InputIt it_last = it;
+				std::advance(it_last, offsets[s + 1] - offsets[s]);
+				func(s, it, it_last, scratch);
+				it = it_last;
+			}
+		};
+
+		std::vector<std::thread> threads;
+		InputIt it = x_first;
+		size_t s_first = 0;
+		for (size_t b = 0; b < n_blocks; ++b)
+		{
+			size_t s_last = n_segments * (b + 1) / n_blocks;
+			if (b + 1 == n_blocks)
+				run_block(it, s_first, s_last);
+			else
+			{
+				threads.push_back(std::thread(run_block, it, s_first, s_last));
+				std::advance(it, offsets[s_last] - offsets[s_first]);
+			}
+			s_first = s_last;
+		}
+		for (auto& t : threads)
+			t.join();
+	}
+
+	/**
+	* Check offsets of segments, and convert them.
+	*/
+	template<typename OContType>
+	std::vector<size_t> check_offsets(const OContType& offsets, size_t size)
+	{
+		std::vector<size_t> o(offsets.begin(), offsets.end());
+		if (o.size() < 2 || o.front() != 0 || o.back() != size || !std::is_sorted(o.begin(), o.end()))
+			throw std::invalid_argument("Offsets must increase from 0 to the size of input.");
+		return o;
+	}
+
+	/**
+	* Means of segments, in one linear pass.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OContType The type of the sequence container of offsets.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container containing the values of all segments.
+	* @param offsets Input sequence container containing the `n_segments + 1` increasing offsets of segments,
+	* from 0 to the size of `x`, computed for instance by `segment_offsets`.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the mean of each segment, NaN for empty segments.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> segmented_mean(
+		const ContType<ValType, Alloc>& x, const OContType& offsets, unsigned int n_threads = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		std::vector<size_t> o = Stats::check_offsets(offsets, x.size());
+		std::vector<double, OutAlloc> x_mean(o.size() - 1, 0.0, alloc);
+		typedef typename ContType<ValType, Alloc>::const_iterator It;
+		typedef std::vector<double, Maths::DoubleAlloc<Alloc>> Scratch;
+		Maths::DoubleAlloc<Alloc> s_alloc(x.get_allocator());
+		Stats::segmented_for_each(x.begin(), o, n_threads, s_alloc, [&x_mean](size_t s, It first, It last, Scratch&) {
+			size_t n = 0;
+			double sx = 0;
+			for (; first != last; ++first, ++n)
+				sx += static_cast<double>(*first);
+			x_mean[s] = n > 0 ? sx / n : std::numeric_limits<double>::quiet_NaN();
+		});
+		return ContType<double, OutAlloc>(x_mean.begin(), x_mean.end(), alloc);
+	}
+
+	/**
+	* Variances of segments, in one linear pass, using sums shifted by the first value of each segment.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OContType The type of the sequence container of offsets.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container containing the values of all segments.
+	* @param offsets Input sequence container containing the `n_segments + 1` increasing offsets of segments.
 	* @param ddof Degree of freedom.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
 	*
-	* @return Output sequence container containing the geometric z-scores of `x`,
-	* whose data type is double to keep the maximum of numerical precision.
+	* @return Output sequence container containing the variance of each segment,
+	* NaN for segments without more than `ddof` values.
 	*/
-	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
-	typename ContType<double, std::allocator<double>> gzscore(const ContType<ValType, Alloc>& x, size_t ddof = 0)
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> segmented_var(
+		const ContType<ValType, Alloc>& x, const OContType& offsets, size_t ddof = 0, unsigned int n_threads = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
 	{
-		ContType<double, std::allocator<double>> x_log = Maths::log(x);
-		ContType<double, std::allocator<double>> gz = Stats::zscore(x_log, ddof);
-		return gz;
+		std::vector<size_t> o = Stats::check_offsets(offsets, x.size());
+		std::vector<double, OutAlloc> x_var(o.size() - 1, 0.0, alloc);
+		typedef typename ContType<ValType, Alloc>::const_iterator It;
+		typedef std::vector<double, Maths::DoubleAlloc<Alloc>> Scratch;
+		Maths::DoubleAlloc<Alloc> s_alloc(x.get_allocator());
+		Stats::segmented_for_each(x.begin(), o, n_threads, s_alloc, [&x_var, ddof](size_t s, It first, It last, Scratch&) {
+			size_t n = 0;
+			double shift = first != last ? static_cast<double>(*first) : 0.0, sx = 0, sxx = 0;
+			for (; first != last; ++first, ++n)
+			{
+				double d = static_cast<double>(*first) - shift;
+				sx += d, sxx += d * d;
+			}
+			x_var[s] = n > ddof ? (sxx - sx * sx / n) / (n - ddof) : std::numeric_limits<double>::quiet_NaN();
+		});
+		return ContType<double, OutAlloc>(x_var.begin(), x_var.end(), alloc);
+	}
+
+	/**
+	* Standard deviations of segments.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OContType The type of the sequence container of offsets.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container containing the values of all segments.
+	* @param offsets Input sequence container containing the `n_segments + 1` increasing offsets of segments.
+	* @param ddof Degree of freedom.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the standard deviation of each segment.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> segmented_std(
+		const ContType<ValType, Alloc>& x, const OContType& offsets, size_t ddof = 0, unsigned int n_threads = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		ContType<double, OutAlloc> x_std = Stats::segmented_var(x, offsets, ddof, n_threads, alloc);
+		for (auto& e : x_std)
+			e = std::sqrt(e);
+		return x_std;
+	}
+
+	/**
+	* Medians of segments, by selection in a scratch buffer reused by all segments of a block,
+	* allocated with the allocator of the input.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OContType The type of the sequence container of offsets.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container containing the values of all segments.
+	* @param offsets Input sequence container containing the `n_segments + 1` increasing offsets of segments.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the median of each segment, NaN for empty segments.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OContType,
+		typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> segmented_median(
+		const ContType<ValType, Alloc>& x, const OContType& offsets, unsigned int n_threads = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		std::vector<size_t> o = Stats::check_offsets(offsets, x.size());
+		std::vector<double, OutAlloc> x_med(o.size() - 1, 0.0, alloc);
+		typedef typename ContType<ValType, Alloc>::const_iterator It;
+		typedef std::vector<double, Maths::DoubleAlloc<Alloc>> Scratch;
+		Maths::DoubleAlloc<Alloc> s_alloc(x.get_allocator());
+		Stats::segmented_for_each(x.begin(), o, n_threads, s_alloc, [&x_med](size_t s, It first, It last, Scratch& x_sel) {
+			x_sel.assign(first, last);
+			size_t n = x_sel.size();
+			if (n == 0)
+			{
+				x_med[s] = std::numeric_limits<double>::quiet_NaN();
+				return;
+			}
+			std::nth_element(x_sel.begin(), x_sel.begin() + n / 2, x_sel.end());
+			double med = x_sel[n / 2];
+			if (n % 2 == 0)
+				med = (*std::max_element(x_sel.begin(), x_sel.begin() + n / 2) + med) / 2;
+			x_med[s] = med;
+		});
+		return ContType<double, OutAlloc>(x_med.begin(), x_med.end(), alloc);
+	}
+
+	// --- NaN-aware functions --- //
+
+	/**
+	* Count and sum of non-NaN values, in one pass masking NaN values instead of branching on them.
+	*/
+	template<typename InputIt>
+	std::pair<size_t, double> nan_count_sum(InputIt first, InputIt last)
+	{
+		size_t count = 0;
+		double sx = 0;
+		Maths::for_each_run(first, last, [&count, &sx](const typename std::iterator_traits<InputIt>::value_type* p, size_t n) {
+			size_t c = count;
+			double s = sx;
+			for (size_t k = 0; k < n; ++k)
+			{
+				double v = static_cast<double>(p[k]);
+				bool is_valid = (v == v);
+				c += is_valid;
+				s += is_valid ? v : 0.0;
+			}
+			count = c, sx = s;
+		});
+		return std::make_pair(count, sx);
+	}
+
+	/**
+	* Mean, ignoring NaN values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*
+	* @return Arithmetic mean of non-NaN values of `x`, NaN if all values are NaN.
+	*
+	* @see [numpy.nanmean](https://numpy.org/doc/stable/reference/generated/numpy.nanmean.html)
+	*/
+	template<typename ContType>
+	double nanmean(const ContType& x)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for nanmean.");
+
+		std::pair<size_t, double> ns = Stats::nan_count_sum(x.begin(), x.end());
+		return ns.first > 0 ? ns.second / ns.first : std::numeric_limits<double>::quiet_NaN();
+	}
+
+	/**
+	* Variance, ignoring NaN values, in two passes without allocation.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom.
+	*
+	* @return Variance of non-NaN values of `x`, NaN if there are not more than `ddof` of them.
+	*/
+	template<typename ContType>
+	double nanvar(const ContType& x, size_t ddof = 0)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for nanvar.");
+
+		std::pair<size_t, double> ns = Stats::nan_count_sum(x.begin(), x.end());
+		if (ns.first <= ddof)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double mean = ns.second / ns.first, sxx = 0;
+		Maths::for_each_run(x.begin(), x.end(), [mean, &sxx](const typename ContType::value_type* p, size_t n) {
+			double s = sxx;
+			for (size_t k = 0; k < n; ++k)
+			{
+				double v = static_cast<double>(p[k]);
+				double d = (v == v) ? v - mean : 0.0;
+				s += d * d;
+			}
+			sxx = s;
+		});
+		return sxx / (ns.first - ddof);
+	}
+
+	/**
+	* Standard deviation, ignoring NaN values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom.
+	*
+	* @return Standard deviation of non-NaN values of `x`.
+	*/
+	template<typename ContType>
+	double nanstd(const ContType& x, size_t ddof = 0)
+	{
+		return std::sqrt(Stats::nanvar(x, ddof));
+	}
+
+	/**
+	* Median, ignoring NaN values.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	*
+	* @return Median of non-NaN values of `x`, NaN if all values are NaN.
+	*/
+	template<typename ContType>
+	double nanmedian(const ContType& x)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for nanmedian.");
+
+		std::vector<double, Maths::ScratchAlloc<ContType>> x_sel(Maths::scratch_allocator(x));
+		x_sel.reserve(x.size());
+		for (const auto& e : x)
+		{
+			double v = static_cast<double>(e);
+			if (v == v)
+				x_sel.push_back(v);
+		}
+		if (x_sel.size() == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+		return Stats::select_quantiles(x_sel, { 0.5 })[0];
+	}
+
+	/**
+	* Standard score (z-score), ignoring NaN values.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the z-scores of `x`, wrt. mean and standard deviation
+	* of non-NaN values, NaN values staying NaN.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> nanzscore(const ContType<ValType, Alloc>& x, size_t ddof = 0, const OutAlloc& alloc = OutAlloc())
+	{
+		double mean = Stats::nanmean(x), std = Stats::nanstd(x, ddof);
+
+		ContType<double, OutAlloc> z(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), z.begin(), [mean, std](const ValType& e) { return (e - mean) / std; });
+		return z;
+	}
+
+	/**
+	* Pearson product-moment correlation coefficient, ignoring pairs containing a NaN value
+	* (pairwise deletion).
+	*
+	* @tparam ContType The type of the sequence containers.
+	* @tparam ValType The numeric data type of the values of the sequence containers.
+	*
+	* @param x, y Input sequence containers.
+	*
+	* @return Pearson product-moment correlation coefficient of pairs of non-NaN values of `x` and `y`.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc>
+	double nanpearsonr(const ContType<ValType, Alloc>& x, const ContType<ValType, Alloc>& y)
+	{
+		size_t size = x.size();
+		if (size != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Inputs have not enough values for nanpearsonr.");
+
+		size_t n = 0;
+		double sx = 0, sy = 0;
+		auto y_it = y.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++y_it)
+		{
+			double vx = static_cast<double>(*x_it), vy = static_cast<double>(*y_it);
+			bool is_valid = (vx == vx) && (vy == vy);
+			n += is_valid;
+			sx += is_valid ? vx : 0.0;
+			sy += is_valid ? vy : 0.0;
+		}
+		if (n == 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double mx = sx / n, my = sy / n, sxx = 0, syy = 0, sxy = 0;
+		y_it = y.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++y_it)
+		{
+			double vx = static_cast<double>(*x_it), vy = static_cast<double>(*y_it);
+			bool is_valid = (vx == vx) && (vy == vy);
+			double dx = is_valid ? vx - mx : 0.0, dy = is_valid ? vy - my : 0.0;
+			sxx += dx * dx, syy += dy * dy, sxy += dx * dy;
+		}
+		if (sxx <= 0 || syy <= 0)
+			return std::numeric_limits<double>::quiet_NaN();
+
+		double r = sxy / (std::sqrt(sxx) * std::sqrt(syy));
+		return std::max(std::min(r, 1.0), -1.0);
+	}
+
+	// --- Combined summary statistics --- //
+
+	/**
+	* Flags selecting the statistics computed by `describe`.
+	* Count, minimum, maximum and mean are always computed.
+	*/
+	enum DescribeFlags
+	{
+		DESCRIBE_MOMENTS = 1 << 0, //!< var, std, skewness, kurtosis
+		DESCRIBE_HMEAN = 1 << 1, //!< hmean
+		DESCRIBE_GMEAN = 1 << 2, //!< gmean
+		DESCRIBE_QUANTILES = 1 << 3, //!< median, first and third quartiles
+		DESCRIBE_MAD = 1 << 4, //!< median_abs_deviation
+		DESCRIBE_ALL = (1 << 5) - 1
+	};
+
+	/**
+	* Summary statistics returned by `describe`, not computed ones being NaN.
+	*/
+	struct Description
+	{
+		size_t count;
+		double min, max;
+		double mean, var, std, skewness, kurtosis;
+		double hmean, gmean;
+		double median, q1, q3, mad;
+	};
+
+	/**
+	* Summary statistics, computed from one pass for moments and means,
+	* and one selection pass on a single scratch buffer for order statistics.
+	*
+	* @tparam ContType The type of the sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom, for variance and standard deviation.
+	* @param flags Combination of `DescribeFlags` selecting the statistics to compute.
+	*
+	* @return Summary statistics of `x`, with the same definitions as
+	* `mean`, `var`, `std`, `skewness`, `kurtosis`, `hmean`, `gmean`, `median` and `median_abs_deviation`;
+	* quartiles being linearly interpolated.
+	*/
+	template<typename ContType>
+	Description describe(const ContType& x, size_t ddof = 0, unsigned int flags = DESCRIBE_ALL)
+	{
+		size_t size = x.size();
+		if (size <= 1 && (flags & DESCRIBE_MOMENTS))
+			throw std::invalid_argument("Input has not enough values for describe.");
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for describe.");
+		if (size - ddof == 0 && (flags & DESCRIBE_MOMENTS))
+			throw std::invalid_argument("Size minus degree of freedom is 0.");
+
+		const double nan = std::numeric_limits<double>::quiet_NaN();
+		Description desc = { size, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan, nan };
+
+		bool with_hmean = (flags & DESCRIBE_HMEAN) != 0, with_gmean = (flags & DESCRIBE_GMEAN) != 0;
+		RunningMoments moments;
+		double sxinv = 0, sxlog = 0;
+		for (const auto& e : x)
+		{
+			double v = static_cast<double>(e);
+			moments.push(v);
+			if (with_hmean)
+			{
+				if (v == 0)
+					throw std::invalid_argument("Input contains zero value(s).");
+				sxinv += 1.0 / v;
+			}
+			if (with_gmean)
+			{
+				if (v <= 0)
+					throw std::invalid_argument("Input contains negative value(s).");
+				sxlog += std::log(v);
+			}
+		}
+
+		desc.min = moments.get_min();
+		desc.max = moments.get_max();
+		desc.mean = moments.get_mean();
+		if (flags & DESCRIBE_MOMENTS)
+		{
+			desc.var = moments.get_var(ddof);
+			desc.std = std::sqrt(desc.var);
+			desc.skewness = moments.get_skewness();
+			desc.kurtosis = moments.get_kurtosis();
+		}
+		if (with_hmean)
+			desc.hmean = size / sxinv;
+		if (with_gmean)
+			desc.gmean = std::exp(sxlog / size);
+
+		if (flags & (DESCRIBE_QUANTILES | DESCRIBE_MAD))
+		{
+			std::vector<double, Maths::ScratchAlloc<ContType>> x_sel(x.begin(), x.end(), Maths::scratch_allocator(x));
+			double med;
+			if (flags & DESCRIBE_QUANTILES)
+			{
+				std::vector<double, Maths::ScratchAlloc<ContType>> x_q = Stats::select_quantiles(x_sel, { 0.25, 0.5, 0.75 });
+				desc.q1 = x_q[0], desc.median = x_q[1], desc.q3 = x_q[2];
+				med = desc.median;
+			}
+			else
+				med = Stats::select_quantiles(x_sel, { 0.5 })[0];
+
+			if (flags & DESCRIBE_MAD)
+			{
+				for (auto& e : x_sel)
+					e = std::fabs(e - med);
+				desc.mad = Stats::select_quantiles(x_sel, { 0.5 })[0];
+			}
+		}
+
+		return desc;
+	}
+
+	// --- Histograms --- //
+
+	/**
+	* Automatic rules computing the width of uniform bins, with the same definitions as NumPy.
+	*/
+	enum BinRule
+	{
+		BINS_STURGES, //!< range / (log2(size) + 1)
+		BINS_SCOTT, //!< (24 * sqrt(pi) / size)^(1/3) * std
+		BINS_FD //!< Freedman-Diaconis, 2 * IQR / size^(1/3)
+	};
+
+	/**
+	* Edges of uniform bins.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param n_bins Number of bins.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the `n_bins + 1` edges of bins
+	* uniformly spread over the range of `x`.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> histogram_bin_edges(
+		const ContType<ValType, Alloc>& x, size_t n_bins, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for histogram_bin_edges.");
+		if (n_bins == 0)
+			throw std::invalid_argument("Number of bins must be positive.");
+
+		auto x_minmax = std::minmax_element(x.begin(), x.end());
+		double lo = static_cast<double>(*x_minmax.first), hi = static_cast<double>(*x_minmax.second);
+		if (lo == hi)
+			lo -= 0.5, hi += 0.5;
+
+		ContType<double, OutAlloc> edges(n_bins + 1, 0.0, alloc);
+		size_t i = 0;
+		for (auto& e : edges)
+			e = lo + (hi - lo) * i++ / n_bins;
+		return edges;
+	}
+
+	/**
+	* Edges of uniform bins, whose width is computed by an automatic rule.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param rule Rule computing the width of bins, the interquartile range of
+	* Freedman-Diaconis rule being computed by `quantiles`.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the edges of bins
+	* uniformly spread over the range of `x`.
+	*
+	* @see [numpy.histogram_bin_edges](https://numpy.org/doc/stable/reference/generated/numpy.histogram_bin_edges.html)
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> histogram_bin_edges(
+		const ContType<ValType, Alloc>& x, BinRule rule, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		size_t size = x.size();
+		if (size == 0)
+			throw std::invalid_argument("Input has not enough values for histogram_bin_edges.");
+
+		auto x_minmax = std::minmax_element(x.begin(), x.end());
+		double range = static_cast<double>(*x_minmax.second) - static_cast<double>(*x_minmax.first);
+
+		double width;
+		if (rule == BINS_STURGES)
+			width = range / (std::log2(static_cast<double>(size)) + 1.0);
+		else if (rule == BINS_SCOTT)
+			width = std::pow(24.0 * std::sqrt(std::acos(-1.0)) / size, 1.0 / 3.0) * (size > 1 ? Stats::std(x) : 0.0);
+		else
+		{
+			std::vector<double, Maths::DoubleAlloc<Alloc>> x_sel(x.begin(), x.end(), Maths::DoubleAlloc<Alloc>(x.get_allocator()));
+			std::vector<double, Maths::DoubleAlloc<Alloc>> x_q = Stats::select_quantiles(x_sel, { 0.25, 0.75 });
+			width = 2.0 * (x_q[1] - x_q[0]) * std::pow(static_cast<double>(size), -1.0 / 3.0);
+		}
+
+		size_t n_bins = width > 0 ? static_cast<size_t>(std::ceil(range / width)) : 1;
+		return Stats::histogram_bin_edges(x, std::max<size_t>(n_bins, 1), alloc);
+	}
+
+	/**
+	* Count values of a range into bins, in private counts.
+	*
+	* Bins are located in O(1) for uniform edges, in a branch-free way
+	* and corrected by one comparison with neighbouring edges,
+	* and by binary search otherwise. Values out of edges are counted in the extra last count.
+	*/
+	template<typename InputIt>
+	void histogram_count(
+		InputIt first, InputIt last, const std::vector<double>& edges, bool is_uniform, std::vector<size_t>& counts
+	)
+	{
+		size_t n_bins = edges.size() - 1;
+		double lo = edges.front(), hi = edges.back();
+		double scale = n_bins / (hi - lo);
+		counts.assign(n_bins + 1, 0);
+
+		for (; first != last; ++first)
+		{
+			double v = static_cast<double>(*first);
+			size_t i;
+			if (is_uniform)
+			{
+				double h = (v - lo) * scale;
+				i = static_cast<size_t>(std::min(std::max(0.0, h), static_cast<double>(n_bins - 1)));
+				i -= static_cast<size_t>(v < edges[i] && i > 0);
+				i += static_cast<size_t>(v >= edges[i + 1] && i + 1 < n_bins);
+			}
+			else
+			{
+				i = std::upper_bound(edges.begin(), edges.end(), v) - edges.begin();
+				i = (i == 0) ? n_bins : std::min(i - 1, n_bins - 1);
+			}
+			// values out of [lo, hi], including NaN, go to the extra count
+			i = (v >= lo && v <= hi) ? i : n_bins;
+			counts[i]++;
+		}
+	}
+
+	/**
+	* Histogram of values, counted by several threads in private counts merged at the end.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam EContType The type of the sequence container of edges.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param edges Input sequence container containing the increasing edges of bins,
+	* computed for instance by `histogram_bin_edges`: all bins are half-open except the last one.
+	* @param n_threads Number of threads, 0 for the number of hardware threads.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the number of values of `x` in each bin,
+	* values out of edges being ignored.
+	*
+	* @see [numpy.histogram](https://numpy.org/doc/stable/reference/generated/numpy.histogram.html)
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename EContType,
+		typename OutAlloc = std::allocator<size_t>>
+	ContType<size_t, OutAlloc> histogram(
+		const ContType<ValType, Alloc>& x, const EContType& edges, unsigned int n_threads = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		std::vector<double> e(edges.begin(), edges.end());
+		if (e.size() < 2)
+			throw std::invalid_argument("Edges have not enough values for histogram.");
+		if (!std::is_sorted(e.begin(), e.end()) || e.front() == e.back())
+			throw std::invalid_argument("Edges must be increasing.");
+
+		size_t n_bins = e.size() - 1;
+		double width = (e.back() - e.front()) / n_bins;
+		bool is_uniform = true;
+		for (size_t i = 1; i <= n_bins && is_uniform; ++i)
+			is_uniform = std::fabs((e[i] - e[i - 1]) - width) <= 1e-9 * width;
+
+		size_t size = x.size();
+		const size_t min_chunk = 1 << 16;
+		if (n_threads == 0)
+			n_threads = std::max(1u, std::thread::hardware_concurrency());
+		size_t n_chunks = std::max<size_t>(1, std::min<size_t>(n_threads, size / min_chunk));
+
+		std::vector<std::vector<size_t>> counts(n_chunks);
+		std::vector<std::thread> threads;
+		auto chunk_first = x.begin();
+		for (size_t c = 0; c < n_chunks; ++c)
+		{
+			auto chunk_last = chunk_first;
+			std::advance(chunk_last, size * (c + 1) / n_chunks - size * c / n_chunks);
+			if (c + 1 == n_chunks)
+				Stats::histogram_count(chunk_first, chunk_last, e, is_uniform, counts[c]);
+			else
+				threads.push_back(std::thread([chunk_first, chunk_last, &e, is_uniform, &counts, c]() {
+					Stats::histogram_count(chunk_first, chunk_last, e, is_uniform, counts[c]);
+				}));
+			chunk_first = chunk_last;
+		}
+		for (auto& t : threads)
+			t.join();
+
+		ContType<size_t, OutAlloc> hist(n_bins, 0, alloc);
+		size_t i = 0;
+		for (auto& h : hist)
+		{
+			h = 0;
+			for (size_t c = 0; c < n_chunks; ++c)
+				h += counts[c][i];
+			++i;
+		}
+		return hist;
+	}
+
+	// --- Transformations --- //
+
+	/**
+	* Center values with respect their mean.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the centered version of `x`,
+	* whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> center(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
+	{
+		double mean = Stats::mean(x);
+
+		ContType<double, OutAlloc> x_cent(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), x_cent.begin(), std::bind2nd(std::minus<double>(), mean));
+		return x_cent;
+	}
+
+	/**
+	* Standard score (z-score).
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the z-scores of `x`,
+	* whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> zscore(const ContType<ValType, Alloc>& x, size_t ddof = 0, const OutAlloc& alloc = OutAlloc())
+	{
+		size_t size = x.size();
+		if (size <= 1)
+			throw std::invalid_argument("Input has not enough values for zscore.");
+		if (size - ddof == 0)
+			throw std::invalid_argument("Size minus degree of freedom is 0.");
+
+		ArrayView<double, OutAlloc> x_cent = Stats::center(Maths::contiguous(x), alloc);
+		double sxx = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
+		double std = std::sqrt(sxx / (size - ddof));
+
+		ContType<double, OutAlloc> z(size, 0.0, alloc);
+		Maths::transform_runs(x_cent.begin(), x_cent.end(), z.begin(), std::bind2nd(std::divides<double>(), std));
+		return z;
+	}
+
+	/**
+	* Geometric standard score (geometric z-score).
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the geometric z-scores of `x`,
+	* whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> gzscore(const ContType<ValType, Alloc>& x, size_t ddof = 0, const OutAlloc& alloc = OutAlloc())
+	{
+		ArrayView<double, OutAlloc> x_log = Maths::log(Maths::contiguous(x), alloc);
+		ArrayView<double, OutAlloc> x_log_z = Stats::zscore(x_log, ddof, alloc);
+		ContType<double, OutAlloc> gz(x_log_z.begin(), x_log_z.end(), alloc);
+		return gz;
+	}
+
+	/**
+	* Robust standard score, using median and median absolute deviation.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the robust z-scores of `x`,
+	* ie `(x - median) / (1.4826 * mad)`, whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> robust_zscore(const ContType<ValType, Alloc>& x, const OutAlloc& alloc = OutAlloc())
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for robust_zscore.");
+
+		std::vector<double, Maths::DoubleAlloc<Alloc>> x_sel(x.begin(), x.end(), Maths::DoubleAlloc<Alloc>(x.get_allocator()));
+		double med = Stats::select_quantiles(x_sel, { 0.5 })[0];
+		for (auto& e : x_sel)
+			e = std::fabs(e - med);
+		double mad = 1.4826 * Stats::select_quantiles(x_sel, { 0.5 })[0];
+
+		ContType<double, OutAlloc> z(x.size(), 0.0, alloc);
+		Maths::transform_runs(x.begin(), x.end(), z.begin(), [med, mad](const ValType& e) { return (e - med) / mad; });
+		return z;
+	}
+
+	// --- Axis-aware functions --- //
+
+	/**
+	* Axis of a matrix along which values are reduced or transformed:
+	* AXIS_0 for each column (reducing along rows), AXIS_1 for each row (reducing along columns),
+	* as the `axis` parameter of NumPy.
+	*/
+	enum Axis
+	{
+		AXIS_0 = 0,
+		AXIS_1 = 1
+	};
+
+	/**
+	* Sums of a function of the values of each column or each row of a matrix,
+	* traversing memory in its storage order:
+	* column reductions of a row-major matrix accumulate one row after the other in a vector of sums,
+	* instead of gathering strided columns.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	* @tparam Func The type of the function, called as `func(k, x)` for the value `x` of the output `k`.
+	*
+	* @param x Input matrix.
+	* @param axis Axis of the reduction.
+	* @param func Function summed over values.
+	*
+	* @return Sums, one per column for AXIS_0 and one per row for AXIS_1.
+	*/
+	template<typename ValType, typename Func>
+	std::vector<double> axis_sum(const MatrixView<ValType>& x, Axis axis, Func func)
+	{
+		size_t n_out = axis == AXIS_0 ? x.cols() : x.rows();
+		size_t n_red = axis == AXIS_0 ? x.rows() : x.cols();
+		std::ptrdiff_t s_out = axis == AXIS_0 ? x.col_stride() : x.row_stride();
+		std::ptrdiff_t s_red = axis == AXIS_0 ? x.row_stride() : x.col_stride();
+
+		std::vector<double> sums(n_out, 0.0);
+		const ValType* data = x.data();
+		if (std::abs(s_out) < std::abs(s_red))
+		{
+			for (size_t r = 0; r < n_red; ++r)
+			{
+				const ValType* p = data + r * s_red;
+				for (size_t k = 0; k < n_out; ++k)
+					sums[k] += func(k, static_cast<double>(p[k * s_out]));
+			}
+		}
+		else
+		{
+			for (size_t k = 0; k < n_out; ++k)
+			{
+				const ValType* p = data + k * s_out;
+				double s = 0;
+				for (size_t r = 0; r < n_red; ++r)
+					s += func(k, static_cast<double>(p[r * s_red]));
+				sums[k] = s;
+			}
+		}
+		return sums;
+	}
+
+	/**
+	* Arithmetic means of the columns or of the rows of a matrix.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	*
+	* @param x Input matrix.
+	* @param axis AXIS_0 for the mean of each column, AXIS_1 for the mean of each row.
+	*
+	* @return Means.
+	*/
+	template<typename ValType>
+	std::vector<double> mean(const MatrixView<ValType>& x, Axis axis)
+	{
+		size_t n = axis == AXIS_0 ? x.rows() : x.cols();
+		if (n == 0)
+			throw std::invalid_argument("Input has not enough values for mean.");
+
+		std::vector<double> means = Stats::axis_sum(x, axis, [](size_t, double e) { return e; });
+		for (auto& m : means)
+			m /= n;
+		return means;
+	}
+
+	/**
+	* Variances of the columns or of the rows of a matrix, computed in two passes, as `Stats::var`.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	*
+	* @param x Input matrix.
+	* @param axis AXIS_0 for the variance of each column, AXIS_1 for the variance of each row.
+	* @param ddof Degree of freedom.
+	*
+	* @return Variances.
+	*/
+	template<typename ValType>
+	std::vector<double> var(const MatrixView<ValType>& x, Axis axis, size_t ddof = 0)
+	{
+		size_t n = axis == AXIS_0 ? x.rows() : x.cols();
+		if (n <= 1)
+			throw std::invalid_argument("Input has not enough values for var.");
+		if (n - ddof == 0)
+			throw std::invalid_argument("Size minus degree of freedom is 0.");
+
+		const std::vector<double> means = Stats::mean(x, axis);
+		std::vector<double> vars = Stats::axis_sum(x, axis, [&means](size_t k, double e) {
+			return (e - means[k]) * (e - means[k]);
+		});
+		for (auto& v : vars)
+			v /= n - ddof;
+		return vars;
+	}
+
+	/**
+	* Standard deviations of the columns or of the rows of a matrix.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	*
+	* @param x Input matrix.
+	* @param axis AXIS_0 for the standard deviation of each column, AXIS_1 for each row.
+	* @param ddof Degree of freedom.
+	*
+	* @return Standard deviations.
+	*/
+	template<typename ValType>
+	std::vector<double> std(const MatrixView<ValType>& x, Axis axis, size_t ddof = 0)
+	{
+		std::vector<double> stds = Stats::var(x, axis, ddof);
+		for (auto& s : stds)
+			s = std::sqrt(s);
+		return stds;
+	}
+
+	/**
+	* Affine transformation `(x - shift) / scale` of each column or each row of a matrix,
+	* traversing memory in its storage order.
+	*
+	* @return Output row-major matrix owning its values.
+	*/
+	template<typename ValType>
+	MatrixView<double> axis_affine(
+		const MatrixView<ValType>& x, Axis axis, const std::vector<double>& shift, const std::vector<double>& scale
+	)
+	{
+		size_t rows = x.rows(), cols = x.cols();
+		MatrixView<double> y(rows, cols);
+		bool is_row_major = std::abs(x.col_stride()) <= std::abs(x.row_stride());
+		size_t n_outer = is_row_major ? rows : cols, n_inner = is_row_major ? cols : rows;
+		for (size_t a = 0; a < n_outer; ++a)
+		{
+			for (size_t b = 0; b < n_inner; ++b)
+			{
+				size_t i = is_row_major ? a : b, j = is_row_major ? b : a;
+				size_t k = axis == AXIS_0 ? j : i;
+				y(i, j) = (static_cast<double>(x(i, j)) - shift[k]) / scale[k];
+			}
+		}
+		return y;
+	}
+
+	/**
+	* Center the columns or the rows of a matrix with respect to their means.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	*
+	* @param x Input matrix.
+	* @param axis AXIS_0 to center each column, AXIS_1 to center each row.
+	*
+	* @return Output row-major matrix owning the centered version of `x`,
+	* whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<typename ValType>
+	MatrixView<double> center(const MatrixView<ValType>& x, Axis axis)
+	{
+		const std::vector<double> means = Stats::mean(x, axis);
+		return Stats::axis_affine(x, axis, means, std::vector<double>(means.size(), 1.0));
+	}
+
+	/**
+	* Standard scores (z-scores) of the columns or of the rows of a matrix.
+	*
+	* @tparam ValType The numeric data type of the values of the matrix.
+	*
+	* @param x Input matrix.
+	* @param axis AXIS_0 to standardize each column, AXIS_1 to standardize each row.
+	* @param ddof Degree of freedom.
+	*
+	* @return Output row-major matrix owning the z-scores of `x`,
+	* whose data type is double to keep the maximum of numerical precision.
+	*/
+	template<typename ValType>
+	MatrixView<double> zscore(const MatrixView<ValType>& x, Axis axis, size_t ddof = 0)
+	{
+		size_t n = axis == AXIS_0 ? x.rows() : x.cols();
+		if (n <= 1)
+			throw std::invalid_argument("Input has not enough values for zscore.");
+
+		const std::vector<double> means = Stats::mean(x, axis);
+		std::vector<double> stds = Stats::std(x, axis, ddof);
+		return Stats::axis_affine(x, axis, means, stds);
+	}
+
+	// --- Exponentially weighted functions --- //
+
+	/**
+	* Exponentially weighted moving mean.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param halflife Number of values after which the weight of a value is halved.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the exponentially weighted mean
+	* of the first values of `x`, at each position.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> ewm_mean(
+		const ContType<ValType, Alloc>& x, double halflife, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for ewm_mean.");
+
+		ExponentialMovingStats ewm(halflife);
+		ContType<double, OutAlloc> x_ewm(x.size(), 0.0, alloc);
+		auto ewm_it = x_ewm.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++ewm_it)
+		{
+			ewm.push(static_cast<double>(*x_it));
+			*ewm_it = ewm.get_mean();
+		}
+		return x_ewm;
+	}
+
+	/**
+	* Exponentially weighted moving variance.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param halflife Number of values after which the weight of a value is halved.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the exponentially weighted variance
+	* of the first values of `x`, at each position.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> ewm_var(
+		const ContType<ValType, Alloc>& x, double halflife, size_t ddof = 0, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for ewm_var.");
+
+		ExponentialMovingStats ewm(halflife);
+		ContType<double, OutAlloc> x_ewm(x.size(), 0.0, alloc);
+		auto ewm_it = x_ewm.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++ewm_it)
+		{
+			ewm.push(static_cast<double>(*x_it));
+			*ewm_it = ewm.get_var(ddof);
+		}
+		return x_ewm;
+	}
+
+	/**
+	* Exponentially weighted moving standard deviation.
+	*
+	* @tparam ContType The type of the sequence container.
+	* @tparam ValType The numeric data type of the values of the sequence container.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x Input sequence container.
+	* @param halflife Number of values after which the weight of a value is halved.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the exponentially weighted standard deviation
+	* of the first values of `x`, at each position.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> ewm_std(
+		const ContType<ValType, Alloc>& x, double halflife, size_t ddof = 0, const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		if (x.size() == 0)
+			throw std::invalid_argument("Input has not enough values for ewm_std.");
+
+		ExponentialMovingStats ewm(halflife);
+		ContType<double, OutAlloc> x_ewm(x.size(), 0.0, alloc);
+		auto ewm_it = x_ewm.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++ewm_it)
+		{
+			ewm.push(static_cast<double>(*x_it));
+			*ewm_it = ewm.get_std(ddof);
+		}
+		return x_ewm;
+	}
+
+	/**
+	* Exponentially weighted moving covariance.
+	*
+	* @tparam ContType The type of the sequence containers.
+	* @tparam ValType The numeric data type of the values of the sequence containers.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x, y Input sequence containers.
+	* @param halflife Number of values after which the weight of a value is halved.
+	* @param ddof Degree of freedom.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the exponentially weighted covariance
+	* of the first values of `x` and `y`, at each position.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> ewm_cov(
+		const ContType<ValType, Alloc>& x, const ContType<ValType, Alloc>& y, double halflife, size_t ddof = 0,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		size_t size = x.size();
+		if (size != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Inputs have not enough values for ewm_cov.");
+
+		ExponentialMovingStats ewm(halflife);
+		ContType<double, OutAlloc> xy_ewm(size, 0.0, alloc);
+		auto y_it = y.begin();
+		auto ewm_it = xy_ewm.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++y_it, ++ewm_it)
+		{
+			ewm.push(static_cast<double>(*x_it), static_cast<double>(*y_it));
+			*ewm_it = ewm.get_cov(ddof);
+		}
+		return xy_ewm;
+	}
+
+	/**
+	* Exponentially weighted moving Pearson correlation coefficient.
+	*
+	* @tparam ContType The type of the sequence containers.
+	* @tparam ValType The numeric data type of the values of the sequence containers.
+	* @tparam OutAlloc The allocator of the output sequence container.
+	*
+	* @param x, y Input sequence containers.
+	* @param halflife Number of values after which the weight of a value is halved.
+	* @param alloc Allocator of the output sequence container, for instance an `ArenaAllocator`.
+	*
+	* @return Output sequence container containing the exponentially weighted correlation
+	* of the first values of `x` and `y`, at each position.
+	*/
+	template<template<typename, typename> class ContType, typename ValType, typename Alloc, typename OutAlloc = std::allocator<double>>
+	ContType<double, OutAlloc> ewm_corr(
+		const ContType<ValType, Alloc>& x, const ContType<ValType, Alloc>& y, double halflife,
+		const OutAlloc& alloc = OutAlloc()
+	)
+	{
+		size_t size = x.size();
+		if (size != y.size())
+			throw std::invalid_argument("Inputs have not the same size.");
+		if (size == 0)
+			throw std::invalid_argument("Inputs have not enough values for ewm_corr.");
+
+		ExponentialMovingStats ewm(halflife);
+		ContType<double, OutAlloc> xy_ewm(size, 0.0, alloc);
+		auto y_it = y.begin();
+		auto ewm_it = xy_ewm.begin();
+		for (auto x_it = x.begin(); x_it != x.end(); ++x_it, ++y_it, ++ewm_it)
+		{
+			ewm.push(static_cast<double>(*x_it), static_cast<double>(*y_it));
+			*ewm_it = ewm.get_corr();
+		}
+		return xy_ewm;
 	}
 
 	// --- Correlation functions --- //
@@ -384,8 +2230,9 @@ namespace Stats
 		if (size == 0)
 			throw std::invalid_argument("Inputs have not enough values for pearsonr.");
 
-		ContType<double, std::allocator<double>> x_cent = Stats::center(x);
-		ContType<double, std::allocator<double>> y_cent = Stats::center(y);
+		Maths::DoubleAlloc<Alloc> alloc(x.get_allocator());
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> x_cent = Stats::center(Maths::contiguous(x), alloc);
+		ArrayView<double, Maths::DoubleAlloc<Alloc>> y_cent = Stats::center(Maths::contiguous(y), alloc);
 
 		double sxx = std::inner_product(x_cent.begin(), x_cent.end(), x_cent.begin(), 0.0);
 		double syy = std::inner_product(y_cent.begin(), y_cent.end(), y_cent.begin(), 0.0);
@@ -486,13 +2333,14 @@ namespace Stats
 	{
 		size_t size = x.size(), i = 0;
 
+		typedef typename std::remove_const<ValType>::type KeyType;
 		auto x_it = x.begin();
-		std::vector<std::pair<ValType, unsigned int>> xr(size);
-		std::vector<std::pair<ValType, unsigned int>>::iterator xr_it = xr.begin();
+		std::vector<std::pair<KeyType, unsigned int>> xr(size);
+		auto xr_it = xr.begin();
 		for (i = 0; x_it != x.end() && xr_it != xr.end(); ++i, ++x_it, ++xr_it)
 			*xr_it = std::make_pair(*x_it, static_cast<unsigned int>(i));
 
-		std::sort(xr.begin(), xr.end(), Stats::op_sort_increase<ValType>);
+		std::sort(xr.begin(), xr.end(), Stats::op_sort_increase<KeyType>);
 
 		ContType<unsigned int, std::allocator<unsigned int>> ranks(size);
 		ContType<unsigned int, std::allocator<unsigned int>>::iterator r_it = ranks.begin();